@@ -0,0 +1,208 @@
+/*
+    __bench_host.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __bench_host.h
+@brief  Host Benchmark Support
+
+Builds the unchanged driver on the host over the trace replay HAL and
+provides timing, trace loading and trace synthesis for the benchmarks.
+
+Include after the module selectors are defined on the compiler command line :
+
+@code
+gcc -O2 -std=c99 -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_conversion.c -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#ifndef _BENCH_HOST_H_
+#define _BENCH_HOST_H_
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+
+#define Delay_1us()
+#define Delay_5us()
+#define Delay_10us()
+#define Delay_1ms()
+#define Delay_10ms()
+
+#include "__pressure_driver.c"
+
+/**
+ * @brief Timestamp counter, CPU cycles on x86 ( TSC ), nanoseconds elsewhere
+ */
+static inline uint64_t bench_cycles()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ( uint64_t ) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Wall clock in seconds
+ */
+static inline double bench_seconds()
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ( double ) ts.tv_sec + ( double ) ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Load a binary trace captured with __PRESSURE_TRACE__
+ *
+ * @return allocated trace, 0 on error
+ */
+static inline uint8_t *bench_loadTrace( const char *path, uint32_t *nBytes )
+{
+    FILE *file;
+    uint8_t *trace;
+    long size;
+
+    file = fopen( path, "rb" );
+
+    if ( file == 0 )
+    {
+        return 0;
+    }
+
+    fseek( file, 0, SEEK_END );
+    size = ftell( file );
+    fseek( file, 0, SEEK_SET );
+
+    trace = ( uint8_t* ) malloc( size > 0 ? size : 1 );
+
+    if ( trace != 0 && fread( trace, 1, size, file ) != ( size_t ) size )
+    {
+        free( trace );
+        trace = 0;
+    }
+
+    fclose( file );
+    *nBytes = ( uint32_t ) size;
+
+    return trace;
+}
+
+/**
+ * @brief Append the I2C record of one pressure_readSample() burst to a trace
+ *
+ * @return record size in bytes
+ */
+static inline uint32_t bench_traceSample( uint8_t *trace, uint32_t tick, uint32_t rawPressure, int16_t rawTemperature )
+{
+    trace[ 0 ] = 0x80 | 5;
+    trace[ 1 ] = 0x28 | 0x80;
+    trace[ 2 ] = tick;
+    trace[ 3 ] = tick >> 8;
+    trace[ 4 ] = tick >> 16;
+    trace[ 5 ] = tick >> 24;
+    trace[ 6 ] = rawPressure;
+    trace[ 7 ] = rawPressure >> 8;
+    trace[ 8 ] = rawPressure >> 16;
+    trace[ 9 ] = rawTemperature;
+    trace[ 10 ] = ( uint16_t ) rawTemperature >> 8;
+
+    return 11;
+}
+
+/**
+ * @brief Bind the driver to the replay HAL and load the trace
+ */
+static inline void bench_replay( const uint8_t *trace, uint32_t nBytes )
+{
+    static T_hal_gpioObj gpio;
+
+    pressure_i2cDriverInit( ( T_PRESSURE_P )&gpio, ( T_PRESSURE_P )&gpio, _PRESSURE_I2C_ADDRESS_1 );
+    pressure_setTickSource( pressure_replayTick );
+    pressure_replayInit( trace, nBytes );
+}
+
+/**
+ * @brief Gaussian noise, sum of 12 uniform numbers
+ */
+static inline double bench_gauss( uint32_t *seed )
+{
+    double sum;
+    uint8_t cnt;
+
+    sum = -6.0;
+
+    for ( cnt = 0; cnt < 12; cnt++ )
+    {
+        *seed = *seed * 1103515245u + 12345u;
+        sum += ( double ) ( ( *seed >> 8 ) & 0xFFFF ) / 65536.0;
+    }
+
+    return sum;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  __bench_host.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
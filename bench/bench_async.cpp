@@ -0,0 +1,188 @@
+/*
+    bench_async.cpp
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_async.cpp
+@brief  Asynchronous Device Benchmark
+
+Sensors served per core at 25 Hz, coroutine device against the blocking
+driver. One tick is 10 us, every I2C transfer takes TRANSFER_TICKS ( a 4 byte
+transaction at 400 kHz ).
+
+Asynchronous : SimLoop runs N_SENSORS simulated sensors, each coroutine waits
+with waitDataReady() and reads with readSample(). The thread only spends CPU
+time, measured with the simulator included.
+
+Blocking : a replayed trace is read with pressure_readData(), STATUS_REG and
+the five output registers per sample, STATUS_REG is always ready on the
+first poll. The thread spends the measured CPU time plus the six transfers
+it waits for.
+
+Sensors per core = 1 s / ( 25 * core time per sample ).
+
+@code
+g++ -O2 -std=c++20 -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_async.cpp -o bench_async -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+#include "__HAL_ASYNC_SIM.hpp"
+
+#define TICK_SECONDS    10e-6
+#define ODR_TICKS       4000
+#define TRANSFER_TICKS  10
+#define POLL_TICKS      100
+#define SAMPLE_RATE     25.0
+#define N_SENSORS       1000
+#define SIM_TICKS       1000000
+#define N_SAMPLES       50000
+
+using namespace pressure::async;
+
+using AsyncSensor = Device< SimSensor >;
+
+static uint32_t asyncSamples;
+
+static Task<> acquire( AsyncSensor &dev )
+{
+    Sample sample;
+
+    if ( !co_await dev.defaultConfig() )
+    {
+        co_return;
+    }
+
+    for ( ;; )
+    {
+        if ( !co_await dev.waitDataReady( POLL_TICKS ) )
+        {
+            co_return;
+        }
+
+        sample = co_await dev.readSample();
+        asyncSamples += sample.ok;
+    }
+}
+
+static double asynchronous()
+{
+    SimLoop loop;
+    std::vector< std::unique_ptr< SimSensor > > buses;
+    std::vector< std::unique_ptr< AsyncSensor > > devices;
+    uint32_t cnt;
+    double t0;
+    double seconds;
+
+    for ( cnt = 0; cnt < N_SENSORS; cnt++ )
+    {
+        buses.emplace_back( new SimSensor( loop, ODR_TICKS, TRANSFER_TICKS, cnt + 1 ) );
+        devices.emplace_back( new AsyncSensor( *buses.back() ) );
+        loop.spawn( acquire( *devices.back() ) );
+    }
+
+    asyncSamples = 0;
+    t0 = bench_seconds();
+    loop.run( SIM_TICKS );
+    seconds = bench_seconds() - t0;
+
+    printf( "async     %4u sensors  %7u samples  %8u transfers  %7.2f us CPU/sample\n",
+            N_SENSORS, asyncSamples, loop.completed(), seconds / asyncSamples * 1e6 );
+
+    return seconds / asyncSamples;
+}
+
+static uint32_t traceRead( uint8_t *trace, uint32_t tick, uint8_t regAddress, uint8_t value )
+{
+    trace[ 0 ] = 0x80 | 1;
+    trace[ 1 ] = regAddress;
+    trace[ 2 ] = tick;
+    trace[ 3 ] = tick >> 8;
+    trace[ 4 ] = tick >> 16;
+    trace[ 5 ] = tick >> 24;
+    trace[ 6 ] = value;
+
+    return 7;
+}
+
+static double blocking()
+{
+    static T_hal_gpioObj gpio;
+    uint8_t *trace;
+    uint32_t nBytes;
+    uint32_t seed;
+    uint32_t cnt;
+    uint32_t raw;
+    uint32_t sum;
+    uint8_t reg;
+    double t0;
+    double cpu;
+
+    trace = ( uint8_t* ) malloc( N_SAMPLES * 6 * 7 );
+    nBytes = 0;
+    seed = 7;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        seed = seed * 1103515245u + 12345u;
+        raw = 4150272u + ( ( seed >> 16 ) & 0x7FF ) - 0x400;
+
+        nBytes += traceRead( trace + nBytes, cnt * ODR_TICKS, _PRESSURE_STATUS_REG, 0x03 );
+        nBytes += traceRead( trace + nBytes, cnt * ODR_TICKS, _PRESSURE_PRESS_POUT_XLB_REH, raw );
+        nBytes += traceRead( trace + nBytes, cnt * ODR_TICKS, _PRESSURE_PRESS_OUT_LSB, raw >> 8 );
+        nBytes += traceRead( trace + nBytes, cnt * ODR_TICKS, _PRESSURE_PRESS_OUT_MSB, raw >> 16 );
+        nBytes += traceRead( trace + nBytes, cnt * ODR_TICKS, _PRESSURE_TEMP_OUT_LSB, ( uint8_t ) -8400 );
+        nBytes += traceRead( trace + nBytes, cnt * ODR_TICKS, _PRESSURE_TEMP_OUT_MSB, ( uint8_t ) ( -8400 >> 8 ) );
+    }
+
+    pressure_i2cDriverInit( ( T_PRESSURE_P )&gpio, ( T_PRESSURE_P )&gpio, _PRESSURE_I2C_ADDRESS_1 );
+    pressure_replayInit( trace, nBytes );
+
+    sum = 0;
+    t0 = bench_seconds();
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        while ( ( pressure_readData( _PRESSURE_STATUS_REG ) & 0x03 ) != 0x03 )
+        {
+        }
+
+        for ( reg = _PRESSURE_PRESS_POUT_XLB_REH; reg <= _PRESSURE_TEMP_OUT_MSB; reg++ )
+        {
+            sum += pressure_readData( reg );
+        }
+    }
+
+    cpu = ( bench_seconds() - t0 ) / N_SAMPLES;
+
+    printf( "blocking                %7u samples  %8u transfers  %7.2f us CPU/sample  sum %u  mismatches %u\n",
+            N_SAMPLES, N_SAMPLES * 6, cpu * 1e6, sum, pressure_replayMismatches() );
+
+    free( trace );
+
+    return cpu + 6 * TRANSFER_TICKS * TICK_SECONDS;
+}
+
+int main()
+{
+    double async;
+    double block;
+
+    async = asynchronous();
+    block = blocking();
+
+    printf( "sensors per core at %.0f Hz : async %.0f  blocking %.0f\n",
+            SAMPLE_RATE, 1.0 / ( SAMPLE_RATE * async ), 1.0 / ( SAMPLE_RATE * block ) );
+
+    return 0;
+}
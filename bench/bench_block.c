@@ -0,0 +1,114 @@
+/*
+    bench_block.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_block.c
+@brief  Block Conversion Benchmark
+
+Converts a buffer of random raw samples with pressure_convertBlock() and with
+a loop over pressure_rawToPressure() / pressure_rawToTemperature(), checks the
+results are bit identical and reports cycles per sample and the speedup.
+Build with -mssse3 or -mavx2 to measure the vector paths.
+
+@code
+gcc -O2 -std=c99 -mavx2 -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_block.c -o bench_block -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define N_SAMPLES       4099
+#define N_PASSES        2000
+
+static uint8_t raw[ N_SAMPLES * 5 ];
+static float blockP[ N_SAMPLES ];
+static float blockT[ N_SAMPLES ];
+static float loopP[ N_SAMPLES ];
+static float loopT[ N_SAMPLES ];
+
+static void loopConvert( const uint8_t *src, uint32_t nSamples, float *outP, float *outT )
+{
+    uint32_t presVal;
+    int16_t tempVal;
+
+    while ( nSamples != 0 )
+    {
+        presVal = ( ( uint32_t ) src[ 2 ] << 16 ) | ( ( uint32_t ) src[ 1 ] << 8 ) | src[ 0 ];
+        tempVal = ( int16_t ) ( ( src[ 4 ] << 8 ) | src[ 3 ] );
+
+        *outP++ = pressure_rawToPressure( presVal );
+        *outT++ = pressure_rawToTemperature( tempVal );
+
+        src += 5;
+        nSamples--;
+    }
+}
+
+int main()
+{
+    uint32_t seed;
+    uint32_t cnt;
+    uint32_t nDiff;
+    uint64_t c0;
+    double cLoop, cBlock;
+
+#if defined( __AVX2__ )
+    printf( "path AVX2\n" );
+#elif defined( __SSSE3__ )
+    printf( "path SSSE3\n" );
+#else
+    printf( "path scalar\n" );
+#endif
+
+    seed = 12345;
+    for ( cnt = 0; cnt < sizeof( raw ); cnt++ )
+    {
+        seed = seed * 1664525 + 1013904223;
+        raw[ cnt ] = seed >> 24;
+    }
+
+    loopConvert( raw, N_SAMPLES, loopP, loopT );
+    pressure_convertBlock( raw, N_SAMPLES, blockP, blockT );
+
+    nDiff = 0;
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        nDiff += memcmp( &loopP[ cnt ], &blockP[ cnt ], sizeof( float ) ) != 0;
+        nDiff += memcmp( &loopT[ cnt ], &blockT[ cnt ], sizeof( float ) ) != 0;
+    }
+
+    c0 = bench_cycles();
+    for ( cnt = 0; cnt < N_PASSES; cnt++ )
+    {
+        loopConvert( raw, N_SAMPLES, loopP, loopT );
+        __asm__ __volatile__( "" : : "r" ( loopP ), "r" ( loopT ) : "memory" );
+    }
+    cLoop = ( double ) ( bench_cycles() - c0 ) / N_PASSES / N_SAMPLES;
+
+    c0 = bench_cycles();
+    for ( cnt = 0; cnt < N_PASSES; cnt++ )
+    {
+        pressure_convertBlock( raw, N_SAMPLES, blockP, blockT );
+        __asm__ __volatile__( "" : : "r" ( blockP ), "r" ( blockT ) : "memory" );
+    }
+    cBlock = ( double ) ( bench_cycles() - c0 ) / N_PASSES / N_SAMPLES;
+
+    printf( "samples %u, mismatches %u\n", N_SAMPLES, nDiff );
+    printf( "%-28s %8.2f cycles/sample\n", "loop rawToPressure/Temp", cLoop );
+    printf( "%-28s %8.2f cycles/sample\n", "pressure_convertBlock", cBlock );
+    printf( "speedup %.2fx\n", cLoop / cBlock );
+
+    return nDiff != 0;
+}
+
@@ -0,0 +1,186 @@
+/*
+    bench_conversion.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_conversion.c
+@brief  Conversion Kernel Benchmark
+
+Sweeps all 2^24 pressure codes and all 2^16 temperature codes through the
+float and integer conversion kernels, reports max/mean error against a double
+reference and conversions per second. The division based conversion used by
+pressure_getPressure() / pressure_getTemperature() before the kernels were
+factored out is measured as the baseline.
+
+@code
+gcc -O2 -std=c99 -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_conversion.c -o bench_conversion -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define N_PRESSURE      0x1000000
+#define N_TEMPERATURE   0x10000
+#define N_PASSES        16
+
+static volatile float sinkFloat;
+static volatile uint32_t sinkInt;
+
+static float divPressure( uint32_t raw )
+{
+    float pressure;
+
+    pressure = ( float ) raw;
+    pressure /= 4096.0;
+
+    return pressure;
+}
+
+static float divTemperature( int16_t raw )
+{
+    float temperature;
+
+    temperature = ( float ) raw;
+    temperature /= 480.0;
+    temperature += 42.5;
+
+    return temperature;
+}
+
+static void report( const char *name, double maxErr, double sumErr, uint32_t n, double seconds, uint32_t nConv, const char *unit )
+{
+    printf( "%-28s max %.3e %-5s mean %.3e %-5s %8.1f Mconv/s\n", name, maxErr, unit, sumErr / n, unit, nConv / seconds * 1e-6 );
+}
+
+static void sweepPressure()
+{
+    uint32_t raw;
+    uint32_t pass;
+    double err;
+    double maxFloat, sumFloat, maxDiv, sumDiv, maxInt, sumInt;
+    double t0, tFloat, tDiv, tInt;
+    float accFloat;
+    uint32_t accInt;
+
+    maxFloat = sumFloat = maxDiv = sumDiv = maxInt = sumInt = 0;
+
+    for ( raw = 0; raw < N_PRESSURE; raw++ )
+    {
+        err = fabs( ( double ) pressure_rawToPressure( raw ) - raw / 4096.0 );
+        maxFloat = err > maxFloat ? err : maxFloat;
+        sumFloat += err;
+
+        err = fabs( ( double ) divPressure( raw ) - raw / 4096.0 );
+        maxDiv = err > maxDiv ? err : maxDiv;
+        sumDiv += err;
+
+        err = fabs( ( double ) pressure_rawToPascal( raw ) - raw * 100.0 / 4096.0 );
+        maxInt = err > maxInt ? err : maxInt;
+        sumInt += err;
+    }
+
+    accFloat = 0;
+    t0 = bench_seconds();
+    for ( pass = 0; pass < N_PASSES; pass++ )
+        for ( raw = pass; raw < N_PRESSURE; raw += N_PASSES )
+            accFloat += pressure_rawToPressure( raw );
+    tFloat = bench_seconds() - t0;
+    sinkFloat = accFloat;
+
+    accFloat = 0;
+    t0 = bench_seconds();
+    for ( pass = 0; pass < N_PASSES; pass++ )
+        for ( raw = pass; raw < N_PRESSURE; raw += N_PASSES )
+            accFloat += divPressure( raw );
+    tDiv = bench_seconds() - t0;
+    sinkFloat = accFloat;
+
+    accInt = 0;
+    t0 = bench_seconds();
+    for ( pass = 0; pass < N_PASSES; pass++ )
+        for ( raw = pass; raw < N_PRESSURE; raw += N_PASSES )
+            accInt += pressure_rawToPascal( raw );
+    tInt = bench_seconds() - t0;
+    sinkInt = accInt;
+
+    report( "pressure  float / 4096.0", maxDiv, sumDiv, N_PRESSURE, tDiv, N_PRESSURE, "mbar" );
+    report( "pressure  rawToPressure", maxFloat, sumFloat, N_PRESSURE, tFloat, N_PRESSURE, "mbar" );
+    report( "pressure  rawToPascal", maxInt, sumInt, N_PRESSURE, tInt, N_PRESSURE, "Pa" );
+}
+
+static void sweepTemperature()
+{
+    int32_t code;
+    uint32_t pass;
+    double ref;
+    double err;
+    double maxFloat, sumFloat, maxDiv, sumDiv, maxInt, sumInt;
+    double t0, tFloat, tDiv, tInt;
+    float accFloat;
+    uint32_t accInt;
+
+    maxFloat = sumFloat = maxDiv = sumDiv = maxInt = sumInt = 0;
+
+    for ( code = -32768; code < 32768; code++ )
+    {
+        ref = code / 480.0 + 42.5;
+
+        err = fabs( ( double ) pressure_rawToTemperature( ( int16_t ) code ) - ref );
+        maxFloat = err > maxFloat ? err : maxFloat;
+        sumFloat += err;
+
+        err = fabs( ( double ) divTemperature( ( int16_t ) code ) - ref );
+        maxDiv = err > maxDiv ? err : maxDiv;
+        sumDiv += err;
+
+        err = fabs( ( double ) pressure_rawToCentiCelsius( ( int16_t ) code ) - ref * 100.0 );
+        maxInt = err > maxInt ? err : maxInt;
+        sumInt += err;
+    }
+
+    accFloat = 0;
+    t0 = bench_seconds();
+    for ( pass = 0; pass < N_PASSES * 256; pass++ )
+        for ( code = -32768; code < 32768; code++ )
+            accFloat += pressure_rawToTemperature( ( int16_t ) code );
+    tFloat = bench_seconds() - t0;
+    sinkFloat = accFloat;
+
+    accFloat = 0;
+    t0 = bench_seconds();
+    for ( pass = 0; pass < N_PASSES * 256; pass++ )
+        for ( code = -32768; code < 32768; code++ )
+            accFloat += divTemperature( ( int16_t ) code );
+    tDiv = bench_seconds() - t0;
+    sinkFloat = accFloat;
+
+    accInt = 0;
+    t0 = bench_seconds();
+    for ( pass = 0; pass < N_PASSES * 256; pass++ )
+        for ( code = -32768; code < 32768; code++ )
+            accInt += pressure_rawToCentiCelsius( ( int16_t ) code );
+    tInt = bench_seconds() - t0;
+    sinkInt = accInt;
+
+    report( "temperature float / 480.0", maxDiv, sumDiv, N_TEMPERATURE, tDiv, N_TEMPERATURE * N_PASSES * 256, "degC" );
+    report( "temperature rawToTemperature", maxFloat, sumFloat, N_TEMPERATURE, tFloat, N_TEMPERATURE * N_PASSES * 256, "degC" );
+    report( "temperature rawToCentiCelsius", maxInt, sumInt, N_TEMPERATURE, tInt, N_TEMPERATURE * N_PASSES * 256, "cdegC" );
+}
+
+int main()
+{
+    sweepPressure();
+    sweepTemperature();
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+    bench_decimator.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_decimator.c
+@brief  Decimator Benchmark
+
+Feeds pressure_decimatorProcess() a noisy constant pressure. Where the 24-bit
+range allows it, the input steps by 1.5 times the restart limit halfway
+through, forcing a filter restart inside a block. For each ratio it reports
+cycles per input sample, the worst and rms output error against the true level
+and the output slots suppressed while the delay lines settle.
+
+@code
+gcc -O2 -std=c99 -D__PRESSURE_DECIMATOR__ -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_decimator.c -o bench_decimator -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define N_INPUT         65536
+#define N_BLOCK         100
+#define N_PASSES        50
+#define LEVEL           2000000
+#define STEP_AT         ( N_INPUT / 2 + 77 )
+#define NOISE           40.0
+
+static uint32_t input[ N_INPUT ];
+static uint32_t output[ N_INPUT ];
+
+static uint32_t run( uint8_t ratio, uint16_t *dropped )
+{
+    T_pressure_decimator dec;
+    uint32_t nOutput;
+    uint32_t pos;
+    uint16_t nBlock;
+
+    pressure_decimatorInit( &dec, ratio );
+    nOutput = 0;
+
+    //  odd block size, restarts and outputs fall anywhere inside a block
+    for ( pos = 0; pos < N_INPUT; pos += nBlock )
+    {
+        nBlock = N_INPUT - pos < N_BLOCK ? N_INPUT - pos : N_BLOCK;
+        nOutput += pressure_decimatorProcess( &dec, input + pos, nBlock, output + nOutput );
+    }
+
+    *dropped = dec.dropped;
+
+    return nOutput;
+}
+
+int main()
+{
+    static const uint8_t ratios[] = { 2, 4, 8, 16, 32, 64 };
+    uint32_t seed;
+    uint32_t cnt;
+    uint32_t pass;
+    uint32_t nOutput;
+    uint32_t step;
+    uint16_t dropped;
+    uint8_t idx;
+    double level;
+    double err;
+    double maxErr;
+    double sumSq;
+    uint64_t c0;
+    double cycles;
+
+    printf( "input noise %.1f counts, step at sample %d\n", NOISE, STEP_AT );
+    printf( "ratio     step  cycles/input  outputs  dropped  max err  rms err\n" );
+
+    for ( idx = 0; idx < sizeof( ratios ); idx++ )
+    {
+        step = 0x40000000 / ( ( uint32_t ) ratios[ idx ] * ratios[ idx ] ) * 3 / 2;
+        step = LEVEL + step < 0x00FFFFFF ? step : 0;
+
+        seed = 1;
+        for ( cnt = 0; cnt < N_INPUT; cnt++ )
+        {
+            level = cnt < STEP_AT ? LEVEL : LEVEL + step;
+            input[ cnt ] = ( uint32_t ) ( level + NOISE * bench_gauss( &seed ) + 0.5 );
+        }
+
+        nOutput = run( ratios[ idx ], &dropped );
+
+        maxErr = 0;
+        sumSq = 0;
+        for ( cnt = 0; cnt < nOutput; cnt++ )
+        {
+            //  settled outputs never mix the two levels
+            level = ( double ) output[ cnt ] < LEVEL + step / 2 ? LEVEL : LEVEL + step;
+            err = fabs( ( double ) output[ cnt ] - level );
+            maxErr = err > maxErr ? err : maxErr;
+            sumSq += err * err;
+        }
+
+        c0 = bench_cycles();
+        for ( pass = 0; pass < N_PASSES; pass++ )
+        {
+            run( ratios[ idx ], &dropped );
+            __asm__ __volatile__( "" : : "r" ( output ) : "memory" );
+        }
+        cycles = ( double ) ( bench_cycles() - c0 ) / N_PASSES / N_INPUT;
+
+        printf( "%5u  %7u  %12.2f  %7u  %7u  %7.1f  %7.2f\n", ratios[ idx ], step, cycles, nOutput, dropped, maxErr, sqrt( sumSq / nOutput ) );
+
+        if ( nOutput + dropped != N_INPUT / ratios[ idx ] )
+        {
+            printf( "output grid lost\n" );
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+    bench_device.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_device.c
+@brief  C++ Device Benchmark
+
+Synthesises a pressure trace and replays it through one of the two read
+paths : built as C it reads with pressure_readSample(), built as C++ it
+reads with pressure::Device<Bus, Address>::readRaw() over a bus policy
+which calls the replay HAL directly. Reports cycles per read, the sum of
+the raw readings and the replay mismatches, both builds must agree on the
+last two. Both are linked with unused sections removed, run.sh prints the
+size of the two binaries.
+
+@code
+gcc -O2 -std=c99 -ffunction-sections -fdata-sections -Wl,--gc-sections -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_device.c -o bench_device_c -lm
+g++ -O2 -std=c++17 -ffunction-sections -fdata-sections -Wl,--gc-sections -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ -x c++ bench_device.c -o bench_device_cpp -lm
+size bench_device_c bench_device_cpp
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define N_SAMPLES       20000
+#define N_PASSES        20
+
+#ifdef __cplusplus
+
+#include "__pressure_device.hpp"
+
+/*
+ * Same transaction framing as the driver I2C register access.
+ */
+struct ReplayBus
+{
+    static constexpr bool spi = false;
+
+    static bool transfer( uint8_t slave, const uint8_t *wBuffer, uint8_t nWrite,
+                          uint8_t *rBuffer, uint8_t nRead )
+    {
+        if ( hal_i2cStart() != 0 )
+        {
+            return false;
+        }
+
+        if ( nRead == 0 )
+        {
+            return hal_i2cWrite( slave, const_cast< uint8_t* >( wBuffer ), nWrite, END_MODE_STOP ) == 0;
+        }
+
+        if ( hal_i2cWrite( slave, const_cast< uint8_t* >( wBuffer ), nWrite, END_MODE_RESTART ) != 0 )
+        {
+            return false;
+        }
+
+        return hal_i2cRead( slave, rBuffer, nRead, END_MODE_STOP ) == 0;
+    }
+};
+
+using Sensor = pressure::Device< ReplayBus, pressure::I2C_ADDRESS_1 >;
+
+static const char *pathName = "Device<Bus, Address>";
+
+static uint32_t readAll()
+{
+    pressure::RawSample sample;
+    uint32_t sum;
+    uint32_t cnt;
+
+    sum = 0;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        if ( Sensor::readRaw( sample ) )
+        {
+            sum += sample.pressure;
+        }
+    }
+
+    return sum;
+}
+
+static void bind()
+{
+}
+
+#else
+
+static const char *pathName = "pressure_readSample";
+
+static uint32_t readAll()
+{
+    T_pressure_sample sample;
+    uint32_t sum;
+    uint32_t cnt;
+
+    sum = 0;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        if ( pressure_readSample( &sample ) == _PRESSURE_OK )
+        {
+            sum += sample.pressure;
+        }
+    }
+
+    return sum;
+}
+
+static void bind()
+{
+    static T_hal_gpioObj gpio;
+
+    pressure_i2cDriverInit( ( T_PRESSURE_P )&gpio, ( T_PRESSURE_P )&gpio, _PRESSURE_I2C_ADDRESS_1 );
+    pressure_setTickSource( pressure_replayTick );
+}
+
+#endif
+
+int main()
+{
+    uint8_t *trace;
+    uint32_t nBytes;
+    uint32_t seed;
+    uint32_t cnt;
+    uint32_t pass;
+    uint32_t sum;
+    uint64_t cycles;
+    uint64_t c0;
+    double raw;
+
+    trace = ( uint8_t* ) malloc( N_SAMPLES * 11 );
+    nBytes = 0;
+    seed = 3;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        raw = 4000000.0 + 20000.0 * sin( cnt * 6.283185307 / 2000.0 ) + 60.0 * bench_gauss( &seed );
+        nBytes += bench_traceSample( trace + nBytes, cnt * 40, ( uint32_t ) raw, ( int16_t ) cnt );
+    }
+
+    bind();
+
+    sum = 0;
+    cycles = 0;
+
+    for ( pass = 0; pass < N_PASSES; pass++ )
+    {
+        pressure_replayInit( trace, nBytes );
+
+        c0 = bench_cycles();
+        sum = readAll();
+        cycles += bench_cycles() - c0;
+    }
+
+    printf( "%-20s  %6.1f cycles/read  sum %10u  mismatches %u\n",
+            pathName, ( double ) cycles / N_PASSES / N_SAMPLES, sum, pressure_replayMismatches() );
+
+    free( trace );
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+/*
+    bench_kalman.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_kalman.c
+@brief  Altitude Kalman Filter Benchmark
+
+Synthesises 25 Hz traces of a 3000 m climb, hold and descent starting at
+sea level, and of the mirrored profile starting at 3000 m, replays them
+through pressure_readSample() and runs pressure_kalmanUpdate(). Reports
+altitude and velocity error against the isothermal truth, with and without
+sensor noise, and cycles per update. A trace captured with __PRESSURE_TRACE__
+can be given as the argument, it is reported for cycles only.
+
+@code
+gcc -O2 -std=c99 -D__PRESSURE_KALMAN__ -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_kalman.c -o bench_kalman -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define SAMPLE_PERIOD   40
+#define CLIMB_RATE      10.0
+#define CLIMB_HEIGHT    3000.0
+#define CLIMB_SAMPLES   7500
+#define HOLD_SAMPLES    1500
+#define N_SAMPLES       ( 2 * CLIMB_SAMPLES + HOLD_SAMPLES )
+#define SETTLE_SAMPLES  250
+#define RES_CONFIG      5
+#define ODR_25HZ        4
+#define ACCEL_NOISE     0.5f
+#define N_PASSES        20
+
+static uint32_t samples[ N_SAMPLES ];
+static double height[ N_SAMPLES ];
+static double speed[ N_SAMPLES ];
+
+static void profile( double start, double direction )
+{
+    uint32_t cnt;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        if ( cnt < CLIMB_SAMPLES )
+        {
+            height[ cnt ] = start + direction * CLIMB_RATE * cnt / 25.0;
+            speed[ cnt ] = direction * CLIMB_RATE;
+        }
+        else if ( cnt < CLIMB_SAMPLES + HOLD_SAMPLES )
+        {
+            height[ cnt ] = start + direction * CLIMB_HEIGHT;
+            speed[ cnt ] = 0.0;
+        }
+        else
+        {
+            height[ cnt ] = start + direction * ( CLIMB_HEIGHT - CLIMB_RATE * ( cnt - CLIMB_SAMPLES - HOLD_SAMPLES ) / 25.0 );
+            speed[ cnt ] = -direction * CLIMB_RATE;
+        }
+    }
+}
+
+static void load( double noise )
+{
+    uint8_t *trace;
+    uint32_t nBytes;
+    uint32_t seed;
+    uint32_t cnt;
+    T_pressure_sample sample;
+    double pascal;
+
+    trace = ( uint8_t* ) malloc( N_SAMPLES * 11 );
+    nBytes = 0;
+    seed = 11;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        pascal = 101325.0 * exp( -height[ cnt ] / 8434.5 ) + noise * bench_gauss( &seed );
+        nBytes += bench_traceSample( trace + nBytes, cnt * SAMPLE_PERIOD, ( uint32_t )( pascal * 40.96 + 0.5 ), 0 );
+    }
+
+    bench_replay( trace, nBytes );
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        pressure_readSample( &sample );
+        samples[ cnt ] = sample.pressure;
+    }
+
+    free( trace );
+}
+
+static double filter( uint32_t nSamples )
+{
+    T_pressure_kalman kf;
+    uint32_t cnt;
+    uint32_t pass;
+    uint64_t c0;
+
+    c0 = bench_cycles();
+    for ( pass = 0; pass < N_PASSES; pass++ )
+    {
+        pressure_kalmanInit( &kf, RES_CONFIG, ODR_25HZ, ACCEL_NOISE );
+
+        for ( cnt = 0; cnt < nSamples; cnt++ )
+        {
+            pressure_kalmanUpdate( &kf, samples[ cnt ] );
+        }
+        __asm__ __volatile__( "" : : "r" ( &kf ) : "memory" );
+    }
+
+    return ( double ) ( bench_cycles() - c0 ) / N_PASSES / nSamples;
+}
+
+static void measure( const char *name, double noise )
+{
+    T_pressure_kalman kf;
+    uint32_t cnt;
+    double err;
+    double maxErr;
+    double sumSq;
+    double sumSqSpeed;
+    double holdErr;
+
+    load( noise );
+    pressure_kalmanInit( &kf, RES_CONFIG, ODR_25HZ, ACCEL_NOISE );
+
+    maxErr = 0;
+    sumSq = 0;
+    sumSqSpeed = 0;
+    holdErr = 0;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        pressure_kalmanUpdate( &kf, samples[ cnt ] );
+
+        if ( cnt < SETTLE_SAMPLES )
+        {
+            continue;
+        }
+
+        err = ( double ) kf.altitude - ( height[ cnt ] - height[ 0 ] );
+        maxErr = fabs( err ) > maxErr ? fabs( err ) : maxErr;
+        sumSq += err * err;
+        sumSqSpeed += ( kf.velocity - speed[ cnt ] ) * ( kf.velocity - speed[ cnt ] );
+
+        if ( cnt == N_SAMPLES / 2 )
+        {
+            holdErr = err;
+        }
+    }
+
+    cnt = N_SAMPLES - SETTLE_SAMPLES;
+    printf( "%-16s max err %6.3f  rms err %6.3f m  at 3 km %+7.3f m  rms speed err %5.3f m/s  %6.1f cycles/update\n",
+            name, maxErr, sqrt( sumSq / cnt ), holdErr, sqrt( sumSqSpeed / cnt ), filter( N_SAMPLES ) );
+}
+
+static void captured( const char *path )
+{
+    uint8_t *trace;
+    uint32_t nBytes;
+    uint32_t nSamples;
+    T_pressure_sample sample;
+
+    trace = bench_loadTrace( path, &nBytes );
+
+    if ( trace == 0 )
+    {
+        printf( "%s : cannot read\n", path );
+        return;
+    }
+
+    bench_replay( trace, nBytes );
+
+    for ( nSamples = 0; nSamples < N_SAMPLES && pressure_readSample( &sample ) == _PRESSURE_OK; nSamples++ )
+    {
+        samples[ nSamples ] = sample.pressure;
+    }
+
+    if ( nSamples != 0 )
+    {
+        printf( "%-16s %u samples  %6.1f cycles/update\n", path, nSamples, filter( nSamples ) );
+    }
+
+    free( trace );
+}
+
+int main( int argc, char **argv )
+{
+    profile( 0.0, 1.0 );
+    measure( "up, clean", 0.0 );
+    measure( "up, noisy", 45.0 / sqrt( 1 << RES_CONFIG ) );
+
+    profile( CLIMB_HEIGHT, -1.0 );
+    measure( "down, clean", 0.0 );
+    measure( "down, noisy", 45.0 / sqrt( 1 << RES_CONFIG ) );
+
+    if ( argc > 1 )
+    {
+        captured( argv[ 1 ] );
+    }
+
+    return 0;
+}
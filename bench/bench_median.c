@@ -0,0 +1,141 @@
+/*
+    bench_median.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_median.c
+@brief  Median Filter Benchmark
+
+Synthesises a noisy pressure trace with spikes, replays it through
+pressure_readSample() and runs pressure_medianPush() against a reference
+that sorts the window for every sample. Reports mismatches and cycles per
+sample of both for the _PRESSURE_MEDIAN_WINDOW the file is built with,
+run.sh builds it for every window from 5 to 63.
+
+@code
+gcc -O2 -std=c99 -D__PRESSURE_MEDIAN__ -D_PRESSURE_MEDIAN_WINDOW=15 -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_median.c -o bench_median -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define N_SAMPLES       20000
+#define N_PASSES        20
+
+static uint32_t samples[ N_SAMPLES ];
+static uint32_t output[ N_SAMPLES ];
+static uint32_t expected[ N_SAMPLES ];
+
+static void heapFilter()
+{
+    T_pressure_median mf;
+    uint32_t cnt;
+
+    pressure_medianInit( &mf );
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        output[ cnt ] = pressure_medianPush( &mf, samples[ cnt ] );
+    }
+}
+
+static void sortFilter()
+{
+    uint32_t window[ _PRESSURE_MEDIAN_WINDOW ];
+    uint32_t value;
+    uint32_t cnt;
+    uint32_t i;
+    uint32_t j;
+
+    for ( cnt = _PRESSURE_MEDIAN_WINDOW - 1; cnt < N_SAMPLES; cnt++ )
+    {
+        for ( i = 0; i < _PRESSURE_MEDIAN_WINDOW; i++ )
+        {
+            value = samples[ cnt + 1 - _PRESSURE_MEDIAN_WINDOW + i ];
+
+            for ( j = i; j > 0 && window[ j - 1 ] > value; j-- )
+            {
+                window[ j ] = window[ j - 1 ];
+            }
+            window[ j ] = value;
+        }
+
+        expected[ cnt ] = window[ _PRESSURE_MEDIAN_WINDOW / 2 ];
+    }
+}
+
+static double measure( void ( *filter )() )
+{
+    uint32_t pass;
+    uint64_t c0;
+
+    c0 = bench_cycles();
+    for ( pass = 0; pass < N_PASSES; pass++ )
+    {
+        filter();
+        __asm__ __volatile__( "" : : : "memory" );
+    }
+
+    return ( double ) ( bench_cycles() - c0 ) / N_PASSES / N_SAMPLES;
+}
+
+int main()
+{
+    uint8_t *trace;
+    uint32_t nBytes;
+    uint32_t seed;
+    uint32_t cnt;
+    uint32_t mismatches;
+    double raw;
+    T_pressure_sample sample;
+
+    trace = ( uint8_t* ) malloc( N_SAMPLES * 11 );
+    nBytes = 0;
+    seed = 5;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        raw = 4000000.0 + 20000.0 * sin( cnt * 6.283185307 / 2000.0 ) + 60.0 * bench_gauss( &seed );
+
+        if ( ( seed >> 16 ) % 50 == 0 )
+        {
+            raw += ( ( seed >> 8 ) & 1 ) ? 50000.0 : -50000.0;
+        }
+
+        nBytes += bench_traceSample( trace + nBytes, cnt * 40, ( uint32_t ) raw, 0 );
+    }
+
+    bench_replay( trace, nBytes );
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        pressure_readSample( &sample );
+        samples[ cnt ] = sample.pressure;
+    }
+
+    heapFilter();
+    sortFilter();
+
+    mismatches = 0;
+    for ( cnt = _PRESSURE_MEDIAN_WINDOW - 1; cnt < N_SAMPLES; cnt++ )
+    {
+        mismatches += ( output[ cnt ] != expected[ cnt ] );
+    }
+
+    printf( "W %2u  heap %6.1f  sort %7.1f cycles/sample  mismatches %u\n",
+            _PRESSURE_MEDIAN_WINDOW, measure( heapFilter ), measure( sortFilter ), mismatches );
+
+    free( trace );
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+    bench_rate.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_rate.c
+@brief  Pressure Rate Estimator Benchmark
+
+Synthesises 25 Hz traces, replays them through pressure_readSample() and runs
+pressure_rateUpdate() against a double precision least squares slope over
+the same window. The extreme cases are steady ramps of 4095 counts per
+sample up and down, the steepest input which does not restart the window
+and the one with the largest slope numerator, the last case is a 10 m/s
+climb with sensor noise. Reports the largest rate error in mPa/s and cycles
+per update for the _PRESSURE_RATE_WINDOW the file is built with, run.sh
+builds it for windows 16 and 64.
+
+@code
+gcc -O2 -std=c99 -D__PRESSURE_RATE__ -D_PRESSURE_RATE_WINDOW=64 -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_rate.c -o bench_rate -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define N_SAMPLES       2000
+#define N_PASSES        50
+#define SAMPLE_RATE     2500
+#define MAX_STEP        4095.0
+
+static uint32_t samples[ N_SAMPLES ];
+static int32_t output[ N_SAMPLES ];
+
+static void load( double start, double step, double noise )
+{
+    uint8_t *trace;
+    uint32_t nBytes;
+    uint32_t seed;
+    uint32_t cnt;
+    T_pressure_sample sample;
+    double raw;
+
+    trace = ( uint8_t* ) malloc( N_SAMPLES * 11 );
+    nBytes = 0;
+    seed = 13;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        raw = start + step * cnt + noise * bench_gauss( &seed );
+        nBytes += bench_traceSample( trace + nBytes, cnt * 40, ( uint32_t )( raw + 0.5 ), 0 );
+    }
+
+    bench_replay( trace, nBytes );
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        pressure_readSample( &sample );
+        samples[ cnt ] = sample.pressure;
+    }
+
+    free( trace );
+}
+
+static uint32_t estimate()
+{
+    T_pressure_rate est;
+    T_pressure_rateResult result;
+    uint32_t valid;
+    uint32_t cnt;
+
+    pressure_rateInit( &est, SAMPLE_RATE );
+    valid = 0;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        if ( pressure_rateUpdate( &est, samples[ cnt ], &result ) )
+        {
+            output[ cnt ] = result.pressureRate;
+            valid++;
+        }
+    }
+
+    return valid;
+}
+
+static double reference( uint32_t last )
+{
+    double numerator;
+    double position;
+    uint32_t i;
+
+    //  slope = 6 sum( ( 2 i - ( W - 1 ) ) p_i ) / ( W ( W^2 - 1 ) ) counts per sample
+    numerator = 0.0;
+
+    for ( i = 0; i < _PRESSURE_RATE_WINDOW; i++ )
+    {
+        position = 2.0 * i - ( _PRESSURE_RATE_WINDOW - 1 );
+        numerator += position * samples[ last + 1 - _PRESSURE_RATE_WINDOW + i ];
+    }
+
+    return 6.0 * numerator / ( ( double ) _PRESSURE_RATE_WINDOW * ( ( double ) _PRESSURE_RATE_WINDOW * _PRESSURE_RATE_WINDOW - 1.0 ) )
+           * SAMPLE_RATE / 100.0 * 100000.0 / 4096.0;
+}
+
+static void measure( const char *name, double start, double step, double noise )
+{
+    uint32_t valid;
+    uint32_t cnt;
+    uint32_t pass;
+    uint64_t c0;
+    double cycles;
+    double expected;
+    double err;
+    double maxErr;
+    double maxRate;
+
+    load( start, step, noise );
+
+    valid = estimate();
+    maxErr = 0.0;
+    maxRate = 0.0;
+
+    for ( cnt = _PRESSURE_RATE_WINDOW - 1; cnt < N_SAMPLES; cnt++ )
+    {
+        expected = reference( cnt );
+        err = fabs( output[ cnt ] - expected );
+        maxErr = ( err > maxErr ) ? err : maxErr;
+        maxRate = ( fabs( expected ) > maxRate ) ? fabs( expected ) : maxRate;
+    }
+
+    c0 = bench_cycles();
+    for ( pass = 0; pass < N_PASSES; pass++ )
+    {
+        estimate();
+        __asm__ __volatile__( "" : : : "memory" );
+    }
+    cycles = ( double ) ( bench_cycles() - c0 ) / N_PASSES / N_SAMPLES;
+
+    printf( "W %2u  %-12s  %4u results  max rate %8.0f  max err %5.1f mPa/s  %5.1f cycles/update\n",
+            _PRESSURE_RATE_WINDOW, name, valid, maxRate, maxErr, cycles );
+}
+
+int main()
+{
+    measure( "ramp up", 4000000.0, MAX_STEP, 0.0 );
+    measure( "ramp down", 12500000.0, -MAX_STEP, 0.0 );
+
+    //  10 m/s climb at sea level is 12 Pa/s, 0.48 Pa per sample
+    measure( "climb, noisy", 4150272.0, -0.48 * 40.96, 45.0 * 40.96 / sqrt( 32.0 ) );
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+    bench_resampler.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_resampler.c
+@brief  Resampler Benchmark
+
+Synthesises a trace of a slow pressure wave sampled at 25 Hz with timestamp
+jitter, replays it through pressure_readSample() and resamples it to a 20 Hz
+grid. Reports the error against the true signal at the grid ticks and cycles
+per output for linear and cubic mode, plus the long interval case where the
+interpolation fraction used to wrap to zero.
+
+@code
+gcc -O2 -std=c99 -D__PRESSURE_RESAMPLER__ -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_resampler.c -o bench_resampler -lm
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define N_SAMPLES       20000
+#define SAMPLE_PERIOD   40
+#define JITTER          3
+#define GRID_PERIOD     50
+#define N_PASSES        50
+
+static T_pressure_sample samples[ N_SAMPLES ];
+static uint32_t output[ N_SAMPLES * 2 ];
+
+static double truth( double tick )
+{
+    return 4000000.0 + 40000.0 * sin( tick * 6.283185307 / 8000.0 ) + 4000.0 * sin( tick * 6.283185307 / 900.0 );
+}
+
+static uint32_t run( uint8_t mode, uint32_t *skipped )
+{
+    T_pressure_resampler rs;
+    uint32_t nOutput;
+    uint32_t cnt;
+
+    pressure_resamplerInit( &rs, mode, 0, GRID_PERIOD );
+    nOutput = 0;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        nOutput += pressure_resamplerPush( &rs, &samples[ cnt ], output + nOutput, 8 );
+    }
+
+    *skipped = rs.skipped;
+
+    return nOutput;
+}
+
+static void measure( const char *name, uint8_t mode )
+{
+    uint32_t nOutput;
+    uint32_t skipped;
+    uint32_t cnt;
+    uint32_t pass;
+    double err;
+    double maxErr;
+    double sumSq;
+    uint64_t c0;
+    double cycles;
+
+    nOutput = run( mode, &skipped );
+
+    maxErr = 0;
+    sumSq = 0;
+    for ( cnt = 0; cnt < nOutput; cnt++ )
+    {
+        err = fabs( ( double ) output[ cnt ] - truth( ( double )( skipped + cnt ) * GRID_PERIOD ) );
+        maxErr = err > maxErr ? err : maxErr;
+        sumSq += err * err;
+    }
+
+    c0 = bench_cycles();
+    for ( pass = 0; pass < N_PASSES; pass++ )
+    {
+        run( mode, &skipped );
+        __asm__ __volatile__( "" : : "r" ( output ) : "memory" );
+    }
+    cycles = ( double ) ( bench_cycles() - c0 ) / N_PASSES / nOutput;
+
+    printf( "%-8s outputs %6u  max err %7.1f  rms err %6.2f counts  %7.1f cycles/output\n",
+            name, nOutput, maxErr, sqrt( sumSq / nOutput ), cycles );
+}
+
+static void longInterval()
+{
+    T_pressure_resampler rs;
+    T_pressure_sample sample;
+    uint32_t value;
+
+    pressure_resamplerInit( &rs, _PRESSURE_RESAMPLE_LINEAR, 40000, 100000 );
+
+    sample.timestamp = 0;
+    sample.pressure = 1000000;
+    pressure_resamplerPush( &rs, &sample, &value, 1 );
+
+    sample.timestamp = 40001;
+    sample.pressure = 2000000;
+    value = 0;
+    pressure_resamplerPush( &rs, &sample, &value, 1 );
+
+    printf( "span 40001 at tick 40000 : %u ( exact %.0f )\n", value, 1000000.0 + 1000000.0 * 40000 / 40001 );
+}
+
+int main()
+{
+    uint8_t *trace;
+    uint32_t nBytes;
+    uint32_t tick;
+    uint32_t seed;
+    uint32_t cnt;
+    int32_t jitter;
+
+    trace = ( uint8_t* ) malloc( N_SAMPLES * 11 );
+    nBytes = 0;
+    seed = 7;
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        jitter = ( int32_t )( bench_gauss( &seed ) * JITTER );
+        jitter = jitter > 15 ? 15 : ( jitter < -15 ? -15 : jitter );
+        tick = cnt * SAMPLE_PERIOD + 20 + jitter;
+        nBytes += bench_traceSample( trace + nBytes, tick, ( uint32_t )( truth( tick ) + 0.5 ), 0 );
+    }
+
+    bench_replay( trace, nBytes );
+
+    for ( cnt = 0; cnt < N_SAMPLES; cnt++ )
+    {
+        pressure_readSample( &samples[ cnt ] );
+    }
+
+    measure( "linear", _PRESSURE_RESAMPLE_LINEAR );
+    measure( "cubic", _PRESSURE_RESAMPLE_CUBIC );
+    longInterval();
+
+    free( trace );
+
+    return 0;
+}
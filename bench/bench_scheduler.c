@@ -0,0 +1,162 @@
+/*
+    bench_scheduler.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   bench_scheduler.c
+@brief  Cooperative Scheduler Benchmark
+
+Runs pressure_schedRun() over simulated time, the sleep hook advances the
+tick counter by the idle time it receives. Reports cycles per scheduling
+step and per dispatched task for 1 to 4 periodic tasks with empty bodies,
+then the example application load : a 25 Hz sample task and a 3 s logging
+task whose body takes 104 ticks ( 100 characters at 9600 baud ), with the
+lateness and missed deadlines it causes. The task table cannot be cleared,
+the argument selects the scenario : number of tasks or app.
+
+@code
+gcc -O2 -std=c99 -D__PRESSURE_SCHEDULER__ -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_scheduler.c -o bench_scheduler -lm
+./bench_scheduler 4
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "__bench_host.h"
+
+#define SIM_TICKS       10000000
+
+static const uint32_t periods[ 4 ] = { 40, 100, 250, 1000 };
+
+static uint32_t now;
+static uint32_t cost[ 4 ];
+
+static uint32_t tick()
+{
+    return now;
+}
+
+static void sleepHook( uint32_t nTicks )
+{
+    now += nTicks;
+}
+
+static void task0()
+{
+    now += cost[ 0 ];
+}
+
+static void task1()
+{
+    now += cost[ 1 ];
+}
+
+static void task2()
+{
+    now += cost[ 2 ];
+}
+
+static void task3()
+{
+    now += cost[ 3 ];
+}
+
+static const T_pressure_taskFp tasks[ 4 ] = { task0, task1, task2, task3 };
+
+static uint32_t dispatches( uint8_t nTasks )
+{
+    T_pressure_taskStats stats;
+    uint32_t total;
+    uint8_t id;
+
+    total = 0;
+
+    for ( id = 0; id < nTasks; id++ )
+    {
+        pressure_schedGetStats( id, &stats );
+        total += stats.nRuns;
+    }
+
+    return total;
+}
+
+static void overhead( uint8_t nTasks )
+{
+    uint32_t steps;
+    uint64_t c0;
+    double cycles;
+    uint8_t id;
+
+    now = 0;
+    pressure_setTickSource( tick );
+    pressure_schedSetSleep( sleepHook );
+
+    for ( id = 0; id < nTasks; id++ )
+    {
+        cost[ id ] = 0;
+        pressure_schedAddTask( tasks[ id ], periods[ id ], 0 );
+    }
+
+    steps = 0;
+    c0 = bench_cycles();
+    while ( now < SIM_TICKS )
+    {
+        pressure_schedRun();
+        steps++;
+    }
+    cycles = ( double ) ( bench_cycles() - c0 );
+
+    printf( "%u tasks  %8u steps  %6.1f cycles/step  %6.1f cycles/dispatch  idle %5.1f %%\n",
+            nTasks, steps, cycles / steps, cycles / dispatches( nTasks ),
+            100.0 * pressure_schedIdleTicks() / now );
+}
+
+static void application()
+{
+    T_pressure_taskStats sampler;
+    T_pressure_taskStats logger;
+
+    now = 0;
+    pressure_setTickSource( tick );
+    pressure_schedSetSleep( sleepHook );
+
+    cost[ 0 ] = 1;
+    cost[ 1 ] = 104;
+    pressure_schedAddTask( tasks[ 0 ], pressure_schedOdrPeriod( 7, 1000 ), 0 );
+    pressure_schedAddTask( tasks[ 1 ], 3000, 0 );
+
+    while ( now < SIM_TICKS / 10 )
+    {
+        pressure_schedRun();
+    }
+
+    pressure_schedGetStats( 0, &sampler );
+    pressure_schedGetStats( 1, &logger );
+
+    printf( "sample  runs %6u  missed %4u  max lateness %3u ticks\n", sampler.nRuns, sampler.nMissed, sampler.maxLateness );
+    printf( "log     runs %6u  missed %4u  max lateness %3u ticks  idle %5.1f %%\n",
+            logger.nRuns, logger.nMissed, logger.maxLateness, 100.0 * pressure_schedIdleTicks() / now );
+}
+
+int main( int argc, char **argv )
+{
+    //  the task table cannot be cleared, every run is one scenario
+    if ( argc > 1 && strcmp( argv[ 1 ], "app" ) == 0 )
+    {
+        application();
+    }
+    else
+    {
+        overhead( ( argc > 1 ) ? ( uint8_t ) atoi( argv[ 1 ] ) : 1 );
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#!/bin/sh
+#
+#   run.sh - build and run the host benchmarks
+#
+#   usage : ./run.sh [benchmark ...]    ( default : all )
+#
+#   CC, CFLAGS, CXX and CXXFLAGS can be overridden, binaries go to a temporary directory.
+
+cd "$( dirname "$0" )" || exit 1
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2 -std=c99 -Wall -Wextra}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2 -std=c++17 -Wall -Wextra}
+OUT=$( mktemp -d ) || exit 1
+trap 'rm -rf "$OUT"' EXIT
+
+build()
+{
+    name=$1
+    shift
+    $CC $CFLAGS -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ "$@" "$name.c" -o "$OUT/$name" -lm || exit 1
+}
+
+conversion()
+{
+    build bench_conversion
+    "$OUT/bench_conversion"
+}
+
+block()
+{
+    build bench_block
+    "$OUT/bench_block"
+    build bench_block -mssse3
+    "$OUT/bench_block"
+    build bench_block -mavx2
+    "$OUT/bench_block"
+}
+
+decimator()
+{
+    build bench_decimator -D__PRESSURE_DECIMATOR__
+    "$OUT/bench_decimator"
+}
+
+resampler()
+{
+    build bench_resampler -D__PRESSURE_RESAMPLER__
+    "$OUT/bench_resampler"
+}
+
+kalman()
+{
+    build bench_kalman -D__PRESSURE_KALMAN__
+    "$OUT/bench_kalman"
+}
+
+median()
+{
+    window=5
+    while [ $window -le 63 ]
+    do
+        build bench_median -D__PRESSURE_MEDIAN__ -D_PRESSURE_MEDIAN_WINDOW=$window
+        "$OUT/bench_median"
+        window=$(( window + 2 ))
+    done
+}
+
+scheduler()
+{
+    build bench_scheduler -D__PRESSURE_SCHEDULER__
+    for scenario in 1 2 3 4 app
+    do
+        "$OUT/bench_scheduler" $scenario
+    done
+}
+
+device()
+{
+    sections="-ffunction-sections -fdata-sections -Wl,--gc-sections"
+    build bench_device $sections
+    mv "$OUT/bench_device" "$OUT/bench_device_c"
+    $CXX $CXXFLAGS $sections -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ -x c++ bench_device.c -o "$OUT/bench_device_cpp" -lm || exit 1
+    "$OUT/bench_device_c"
+    "$OUT/bench_device_cpp"
+    ( cd "$OUT" && size bench_device_c bench_device_cpp )
+}
+
+async()
+{
+    $CXX $CXXFLAGS -std=c++20 -I../library -I../library/HAL -D__PRESSURE_HAL_REPLAY__ bench_async.cpp -o "$OUT/bench_async" -lm || exit 1
+    "$OUT/bench_async"
+}
+
+rate()
+{
+    for window in 16 64
+    do
+        build bench_rate -D__PRESSURE_RATE__ -D_PRESSURE_RATE_WINDOW=$window
+        "$OUT/bench_rate"
+    done
+}
+
+[ $# -eq 0 ] && set -- conversion block decimator resampler kalman median scheduler device async rate
+
+for bench in "$@"
+do
+    echo "== $bench"
+    $bench
+done
@@ -20,7 +20,9 @@ Description :
 - Application Task - (code snippet) This is a example which demonstrates the use of Pressure Click board.
      Measured pressure and temperature data from the LPS331AP sensor on Pressure click board.
      Results are being sent to the Usart Terminal where you can track their changes.
-     All data logs write on usb uart changes for every 3 sec.
+     Samples are read at the sensor ODR and logged every 3 sec by the cooperative scheduler,
+     a 1 ms timer interrupt drives the tick and between the tasks the core sleeps with WFI.
+     The library must be built with __PRESSURE_SCHEDULER__ selected.
 
 
 */
@@ -33,6 +35,48 @@ float pressure;
 float temperature;
 char logText[ 50 ];
 char degCel[ 4 ];
+volatile uint32_t tickCount;
+T_pressure_sample sample;
+
+void sampleTask();
+void applicationTask();
+
+//  SysTick core registers
+#define SYSTICK_CTRL    ( *( volatile uint32_t* ) 0xE000E010 )
+#define SYSTICK_LOAD    ( *( volatile uint32_t* ) 0xE000E014 )
+#define SYSTICK_VAL     ( *( volatile uint32_t* ) 0xE000E018 )
+
+void tickInterrupt() iv IVT_INT_SysTick ics ICS_AUTO
+{
+    tickCount++;
+}
+
+void tickInit()
+{
+    //  SysTick from the 120 MHz core clock, 1 ms
+    SYSTICK_LOAD = 120000 - 1;
+    SYSTICK_VAL = 0;
+    SYSTICK_CTRL = 0x07;
+    EnableInterrupts();
+}
+
+uint32_t applicationTick()
+{
+    return tickCount;
+}
+
+void applicationSleep( uint32_t nTicks )
+{
+    uint32_t start;
+
+    //  the 1 ms timer interrupt wakes the core, the INT pin is checked on every tick
+    start = applicationTick();
+
+    while ( ( nTicks == _PRESSURE_SCHED_UNTIL_INT ) ? !pressure_getInterruptState() : ( applicationTick() - start < nTicks ) )
+    {
+        asm WFI;
+    }
+}
 
 void systemInit()
 {
@@ -66,28 +110,34 @@ void applicationInit()
 
     mikrobus_logWrite( "----------------------------", _LOG_LINE );
     Delay_100ms();
+
+    //  default configuration runs pressure at 25 Hz ( ODR code 7 )
+    tickInit();
+    pressure_setTickSource( applicationTick );
+    pressure_schedSetSleep( applicationSleep );
+    pressure_schedAddTask( sampleTask, pressure_schedOdrPeriod( 7, 1000 ), 0 );
+    pressure_schedAddTask( applicationTask, 3000, 0 );
+}
+
+void sampleTask()
+{
+    pressure_readSample( &sample );
 }
 
 void applicationTask()
 {
-    pressure = pressure_getPressure();
-    Delay_10ms();
+    pressure = pressure_rawToPressure( sample.pressure );
     mikrobus_logWrite( " Pressure   : ", _LOG_TEXT );
     FloatToStr( pressure, logText );
     mikrobus_logWrite( logText, _LOG_TEXT );
     mikrobus_logWrite( " mbar", _LOG_LINE );
 
-    temperature = pressure_getTemperature();
-    Delay_10ms();
+    temperature = pressure_rawToTemperature( sample.temperature );
     mikrobus_logWrite( " Temperature: ", _LOG_TEXT );
     FloatToStr( temperature, logText );
     mikrobus_logWrite( logText, _LOG_TEXT );
     mikrobus_logWrite( degCel, _LOG_LINE );
     mikrobus_logWrite( "----------------------------", _LOG_LINE );
-
-    Delay_1sec();
-    Delay_1sec();
-    Delay_1sec();
 }
 
 void main()
@@ -97,6 +147,6 @@ void main()
 
     while (1)
     {
-            applicationTask();
+            pressure_schedRun();
     }
 }
\ No newline at end of file
@@ -0,0 +1,367 @@
+/*
+    __HAL_ASYNC_SIM.hpp
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __HAL_ASYNC_SIM.hpp
+@brief  Simulated Asynchronous HAL
+
+Host event loop which multiplexes any number of simulated LPS331AP sensors
+on one thread for the coroutine interface in __pressure_async.hpp.
+
+Time is virtual. Every transfer completes transferTicks after submission, the
+sensor register file converts a new sample every odrTicks while CTRL_REG1 PD
+is set. Reading PRESS_OUT_H / TEMP_OUT_H clears the STATUS_REG data available flags.
+
+@code
+pressure::async::SimLoop loop;
+pressure::async::SimSensor bus( loop, 40, 1 );
+pressure::async::Device< pressure::async::SimSensor > dev( bus );
+
+loop.spawn( acquire( dev ) );
+loop.run( 100000 );
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#ifndef _HAL_ASYNC_SIM_HPP_
+#define _HAL_ASYNC_SIM_HPP_
+
+#include <queue>
+#include <vector>
+#include <memory>
+
+#include "__pressure_async.hpp"
+
+namespace pressure
+{
+namespace async
+{
+
+class SimSensor;
+
+/**
+ * @brief Single thread event loop with virtual time
+ */
+class SimLoop
+{
+public:
+
+    struct Operation
+    {
+        uint32_t        due;                /**< Completion tick */
+        uint32_t        sequence;           /**< Submission order, keeps equal ticks FIFO */
+        SimSensor       *sensor;            /**< Target sensor, nullptr for delays */
+        uint8_t         wBuffer[ 8 ];
+        uint8_t         nWrite;
+        uint8_t         *rBuffer;
+        uint8_t         nRead;
+        Completion      *done;
+    };
+
+    SimLoop() : _now( 0 ), _sequence( 0 ), _completed( 0 )
+    {
+    }
+
+    uint32_t now() const noexcept
+    {
+        return _now;
+    }
+
+    uint32_t completed() const noexcept
+    {
+        return _completed;
+    }
+
+    void post( Operation op )
+    {
+        op.sequence = _sequence++;
+        _queue.push( op );
+    }
+
+    /**
+     * @brief Take ownership of a top level task and start it
+     */
+    void spawn( Task<> &&task )
+    {
+        _tasks.emplace_back( new Task<>( std::move( task ) ) );
+        _tasks.back()->start();
+    }
+
+    /**
+     * @brief Complete operations until the tick limit or until nothing is pending
+     */
+    void run( uint32_t untilTick );
+
+private:
+
+    struct Later
+    {
+        bool operator()( const Operation &a, const Operation &b ) const noexcept
+        {
+            if ( a.due != b.due )
+            {
+                return ( int32_t )( a.due - b.due ) > 0;
+            }
+
+            return ( int32_t )( a.sequence - b.sequence ) > 0;
+        }
+    };
+
+    uint32_t _now;
+    uint32_t _sequence;
+    uint32_t _completed;
+    std::priority_queue< Operation, std::vector< Operation >, Later > _queue;
+    std::vector< std::unique_ptr< Task<> > > _tasks;
+};
+
+/**
+ * @brief Simulated sensor, asynchronous bus policy for one device
+ */
+class SimSensor
+{
+public:
+
+    static constexpr bool spi = false;
+
+    /**
+     * @param[in] loop                  Event loop
+     * @param[in] odrTicks              Conversion period
+     * @param[in] transferTicks         Transfer latency
+     * @param[in] seed                  Pressure noise seed
+     */
+    SimSensor( SimLoop &loop, uint32_t odrTicks, uint32_t transferTicks, uint32_t seed = 1 )
+        : _loop( loop ), _odrTicks( odrTicks ), _transferTicks( transferTicks ), _nextConversion( 0 ), _noise( seed )
+    {
+        for ( uint8_t &reg : _regs )
+        {
+            reg = 0;
+        }
+
+        _regs[ reg::WHO_AM_I ] = reg::DEVICE_ID;
+    }
+
+    uint8_t *registers() noexcept
+    {
+        return _regs;
+    }
+
+    bool submit( uint8_t slave, const uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead, Completion &done )
+    {
+        SimLoop::Operation op;
+        uint8_t cnt;
+
+        if ( nWrite > sizeof( op.wBuffer ) )
+        {
+            return false;
+        }
+
+        ( void )slave;
+
+        op.due = _loop.now() + _transferTicks;
+        op.sensor = this;
+        op.nWrite = nWrite;
+        op.rBuffer = rBuffer;
+        op.nRead = nRead;
+        op.done = &done;
+
+        for ( cnt = 0; cnt < nWrite; cnt++ )
+        {
+            op.wBuffer[ cnt ] = wBuffer[ cnt ];
+        }
+
+        _loop.post( op );
+
+        return true;
+    }
+
+    bool after( uint32_t nTicks, Completion &done )
+    {
+        SimLoop::Operation op;
+
+        op.due = _loop.now() + nTicks;
+        op.sensor = nullptr;
+        op.nWrite = 0;
+        op.rBuffer = nullptr;
+        op.nRead = 0;
+        op.done = &done;
+
+        _loop.post( op );
+
+        return true;
+    }
+
+    /**
+     * @brief Execute the transfer against the register file, called by the loop
+     *
+     * The auto increment address wraps inside the 7-bit register space.
+     */
+    bool execute( const SimLoop::Operation &op )
+    {
+        uint8_t regAddress;
+        uint8_t cnt;
+
+        _convert();
+
+        if ( op.nWrite == 0 )
+        {
+            return false;
+        }
+
+        regAddress = op.wBuffer[ 0 ] & 0x7F;
+
+        for ( cnt = 1; cnt < op.nWrite; cnt++ )
+        {
+            _regs[ regAddress ] = op.wBuffer[ cnt ];
+
+            if ( op.wBuffer[ 0 ] & 0x80 )
+            {
+                regAddress = ( regAddress + 1 ) & 0x7F;
+            }
+        }
+
+        for ( cnt = 0; cnt < op.nRead; cnt++ )
+        {
+            op.rBuffer[ cnt ] = _regs[ regAddress ];
+
+            if ( regAddress == reg::PRESS_OUT_H )
+            {
+                _regs[ reg::STATUS ] &= ~field::P_DA::mask;
+            }
+            if ( regAddress == reg::TEMP_OUT_H )
+            {
+                _regs[ reg::STATUS ] &= ~field::T_DA::mask;
+            }
+
+            if ( op.wBuffer[ 0 ] & 0x80 )
+            {
+                regAddress = ( regAddress + 1 ) & 0x7F;
+            }
+        }
+
+        return true;
+    }
+
+private:
+
+    void _convert()
+    {
+        uint32_t pressure;
+
+        if ( !( _regs[ reg::CTRL_REG1 ] & field::PD::mask ) )
+        {
+            _nextConversion = _loop.now() + _odrTicks;
+
+            return;
+        }
+
+        while ( ( int32_t )( _loop.now() - _nextConversion ) >= 0 )
+        {
+            _noise = _noise * 1103515245u + 12345u;
+
+            //  1013.25 mbar +- 0.25 mbar, 25 degrees Celsius
+            pressure = 4150272u + ( ( _noise >> 16 ) & 0x7FF ) - 0x400;
+
+            _regs[ reg::PRESS_OUT_XL ] = pressure;
+            _regs[ reg::PRESS_OUT_L ] = pressure >> 8;
+            _regs[ reg::PRESS_OUT_H ] = pressure >> 16;
+            _regs[ reg::TEMP_OUT_L ] = ( uint8_t )( -8400 );
+            _regs[ reg::TEMP_OUT_H ] = ( uint8_t )( -8400 >> 8 );
+            _regs[ reg::STATUS ] |= field::P_DA::mask | field::T_DA::mask;
+
+            _nextConversion += _odrTicks;
+        }
+    }
+
+    SimLoop     &_loop;
+    uint32_t    _odrTicks;
+    uint32_t    _transferTicks;
+    uint32_t    _nextConversion;
+    uint32_t    _noise;
+    uint8_t     _regs[ 128 ];
+};
+
+inline void SimLoop::run( uint32_t untilTick )
+{
+    Operation op;
+
+    while ( !_queue.empty() )
+    {
+        op = _queue.top();
+
+        if ( ( int32_t )( op.due - untilTick ) > 0 )
+        {
+            break;
+        }
+
+        _queue.pop();
+        _now = op.due;
+
+        if ( op.sensor != nullptr )
+        {
+            op.done->ok = op.sensor->execute( op );
+        }
+        else
+        {
+            op.done->ok = true;
+        }
+
+        _completed++;
+        op.done->handle.resume();
+    }
+
+    _now = untilTick;
+}
+
+} // namespace async
+} // namespace pressure
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  __HAL_ASYNC_SIM.hpp
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
@@ -0,0 +1,339 @@
+/*
+    __HAL_REPLAY.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __HAL_REPLAY.c
+@brief  Trace Replay HAL
+
+Host HAL which serves I2C/SPI transactions of the unchanged driver from
+a binary trace captured with __PRESSURE_TRACE__ selected.
+
+Each transaction takes the next trace record. Read transactions get the
+recorded data bytes, records captured with bus error flag fail the same way.
+Register address byte, direction, interface and written data are compared
+against the record, every difference is counted as a mismatch. INT pin
+records ( header 0x1F ) are served to the driver INT pin reads.
+*/
+/* -------------------------------------------------------------------------- */
+
+#ifndef END_MODE_RESTART
+#define END_MODE_RESTART  0
+#endif
+#ifndef END_MODE_STOP
+#define END_MODE_STOP     1
+#endif
+
+static const uint8_t *_replayTrace;
+static uint32_t _replaySize;
+static uint32_t _replayPos;
+static uint32_t _replayTick;
+static uint8_t  _replayHeader;
+static uint8_t  _replayReg;
+static const uint8_t *_replayData;
+static uint8_t  _replayInt;
+static uint32_t _replayMismatches;
+
+static uint8_t _replayIntPending()
+{
+    if ( _replayPos + 6 > _replaySize )
+    {
+        return 0;
+    }
+
+    return _replayTrace[ _replayPos ] == 0x1F;
+}
+
+static void _replayIntTake()
+{
+    _replayInt = _replayTrace[ _replayPos + 1 ];
+    _replayPos += 6;
+}
+
+static uint8_t _replayNext()
+{
+    uint8_t nData;
+
+    //  INT pin change the driver did not read before this transaction
+    while ( _replayIntPending() )
+    {
+        _replayIntTake();
+        _replayMismatches++;
+    }
+
+    if ( _replayPos + 6 > _replaySize )
+    {
+        _replayHeader = 0x20;
+        _replayReg = 0;
+        _replayData = 0;
+        _replayMismatches++;
+
+        return 0;
+    }
+
+    _replayHeader = _replayTrace[ _replayPos ];
+    _replayReg = _replayTrace[ _replayPos + 1 ];
+    nData = _replayHeader & 0x1F;
+
+    _replayTick = _replayTrace[ _replayPos + 5 ];
+    _replayTick <<= 8;
+    _replayTick |= _replayTrace[ _replayPos + 4 ];
+    _replayTick <<= 8;
+    _replayTick |= _replayTrace[ _replayPos + 3 ];
+    _replayTick <<= 8;
+    _replayTick |= _replayTrace[ _replayPos + 2 ];
+
+    _replayData = _replayTrace + _replayPos + 6;
+    _replayPos += 6 + nData;
+
+    if ( _replayPos > _replaySize )
+    {
+        _replayHeader = 0x20;
+        _replayData = 0;
+        _replayPos = _replaySize;
+
+        return 0;
+    }
+
+    return 1;
+}
+
+static void _replayCheck(uint8_t *pBuf, uint16_t nBytes, uint8_t header)
+{
+    uint16_t cnt;
+
+    if ( _replayData == 0 )
+    {
+        return;
+    }
+
+    if ( ( _replayHeader & 0xC0 ) != header || _replayReg != pBuf[ 0 ] )
+    {
+        _replayMismatches++;
+
+        return;
+    }
+
+    if ( header & 0x80 )
+    {
+        return;
+    }
+
+    if ( nBytes - 1 != ( _replayHeader & 0x1F ) )
+    {
+        _replayMismatches++;
+
+        return;
+    }
+
+    for ( cnt = 1; cnt < nBytes; cnt++ )
+    {
+        if ( pBuf[ cnt ] != _replayData[ cnt - 1 ] )
+        {
+            _replayMismatches++;
+
+            return;
+        }
+    }
+}
+
+static void _replayCopy(uint8_t *pBuf, uint16_t nBytes)
+{
+    uint16_t cnt;
+    uint8_t nData;
+
+    nData = _replayHeader & 0x1F;
+
+    for ( cnt = 0; cnt < nBytes; cnt++ )
+    {
+        if ( _replayData != 0 && cnt < nData )
+        {
+            pBuf[ cnt ] = _replayData[ cnt ];
+        }
+        else
+        {
+            pBuf[ cnt ] = 0;
+        }
+    }
+}
+
+static void hal_replayInit(const uint8_t *trace, uint32_t nBytes)
+{
+    _replayTrace = trace;
+    _replaySize = nBytes;
+    _replayPos = 0;
+    _replayTick = 0;
+    _replayHeader = 0;
+    _replayReg = 0;
+    _replayData = 0;
+    _replayInt = 0;
+    _replayMismatches = 0;
+}
+
+static uint32_t hal_replayTick()
+{
+    return _replayTick;
+}
+
+static uint8_t hal_replayDone()
+{
+    return _replayPos >= _replaySize;
+}
+
+static uint8_t hal_replayInt()
+{
+    if ( _replayIntPending() )
+    {
+        _replayIntTake();
+    }
+
+    return _replayInt;
+}
+
+static uint32_t hal_replayMismatches()
+{
+    return _replayMismatches;
+}
+
+/* ------------------------------------------------------------------- SPI */
+
+#ifdef __HAL_SPI__
+
+static void hal_spiMap(T_HAL_P spiObj)
+{
+    spiObj = spiObj;
+}
+
+static void hal_spiWrite(uint8_t *pBuf, uint16_t nBytes)
+{
+    _replayNext();
+    _replayCheck( pBuf, nBytes, 0x40 | ( pBuf[ 0 ] & 0x80 ) );
+}
+
+static void hal_spiRead(uint8_t *pBuf, uint16_t nBytes)
+{
+    _replayCopy( pBuf, nBytes );
+}
+
+#endif
+
+/* ------------------------------------------------------------------- I2C */
+
+#ifdef __HAL_I2C__
+
+static void hal_i2cMap(T_HAL_P i2cObj)
+{
+    i2cObj = i2cObj;
+}
+
+static int hal_i2cStart(void)
+{
+    _replayNext();
+
+    return 0;
+}
+
+static int hal_i2cWrite(uint8_t slaveAddress, uint8_t *pBuf, uint16_t nBytes, uint8_t endMode)
+{
+    slaveAddress = slaveAddress;
+
+    _replayCheck( pBuf, nBytes, ( endMode == END_MODE_STOP ) ? 0x00 : 0x80 );
+
+    if ( endMode == END_MODE_STOP && ( _replayHeader & 0x20 ) )
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int hal_i2cRead(uint8_t slaveAddress, uint8_t *pBuf, uint16_t nBytes, uint8_t endMode)
+{
+    slaveAddress = slaveAddress;
+    endMode = endMode;
+
+    _replayCopy( pBuf, nBytes );
+
+    if ( _replayHeader & 0x20 )
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif
+
+/* ------------------------------------------------------------------- UART */
+
+#ifdef __HAL_UART__
+
+static void hal_uartMap(T_HAL_P uartObj)
+{
+    uartObj = uartObj;
+}
+
+static void hal_uartWrite(uint8_t input)
+{
+    input = input;
+}
+
+static uint8_t hal_uartRead()
+{
+    return 0;
+}
+
+static uint8_t hal_uartReady()
+{
+    return 0;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  __HAL_REPLAY.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
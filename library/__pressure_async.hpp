@@ -0,0 +1,535 @@
+/*
+    __pressure_async.hpp
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __pressure_async.hpp
+@brief  Pressure C++ Asynchronous Device
+
+Header only C++20 coroutine interface to the LPS331AP sensor on Pressure click board.
+
+Acquisition code is written as sequential logic and suspends on every bus
+transfer instead of blocking the thread :
+
+@code
+pressure::async::Task<> acquire( pressure::async::Device< Bus > &dev )
+{
+    bool ready;
+
+    for ( ;; )
+    {
+        ready = co_await dev.waitDataReady();
+
+        if ( ready )
+        {
+            pressure::async::Sample sample = co_await dev.readSample();
+            ...
+        }
+    }
+}
+@endcode
+
+Asynchronous bus policy requirements :
+
+@code
+struct Bus
+{
+    static constexpr bool spi = false;
+
+    //  Start the transfer and return immediately. Buffers stay valid until the
+    //  event loop sets done.ok and resumes done.handle. Return false when the
+    //  transfer could not be started ( done is then left untouched ).
+    bool submit( uint8_t slave, const uint8_t *wBuffer, uint8_t nWrite,
+                 uint8_t *rBuffer, uint8_t nRead, Completion &done );
+
+    //  Resume done.handle from the event loop after nTicks.
+    bool after( uint32_t nTicks, Completion &done );
+};
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#ifndef _PRESSURE_ASYNC_HPP_
+#define _PRESSURE_ASYNC_HPP_
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "__pressure_device.hpp"
+
+namespace pressure
+{
+namespace async
+{
+
+/** @defgroup PRESSURE_ASYNC_TASK Coroutine Task */                 /** @{ */
+
+/**
+ * @brief Transfer completion record, filled by the bus policy
+ */
+struct Completion
+{
+    std::coroutine_handle<>     handle;     /**< Coroutine to resume */
+    bool                        ok;         /**< Transfer status */
+};
+
+template < class T = void >
+class Task;
+
+namespace detail
+{
+    struct PromiseBase
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            template < class P >
+            std::coroutine_handle<> await_suspend( std::coroutine_handle< P > h ) noexcept
+            {
+                std::coroutine_handle<> next = h.promise().continuation;
+
+                return next ? next : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        std::coroutine_handle<> continuation;
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+
+    template < class T >
+    struct Promise : PromiseBase
+    {
+        T value {};
+
+        Task< T > get_return_object() noexcept;
+
+        void return_value( T v )
+        {
+            value = std::move( v );
+        }
+
+        T result()
+        {
+            return std::move( value );
+        }
+    };
+
+    template <>
+    struct Promise< void > : PromiseBase
+    {
+        Task< void > get_return_object() noexcept;
+
+        void return_void() noexcept
+        {
+        }
+
+        void result() noexcept
+        {
+        }
+    };
+}
+
+/**
+ * @brief Lazily started coroutine task
+ *
+ * Awaiting the task starts it and resumes the awaiting coroutine when it
+ * finishes ( symmetric transfer, no executor involved ). Top level tasks are
+ * started with start() and polled with done().
+ */
+template < class T >
+class Task
+{
+public:
+
+    using promise_type = detail::Promise< T >;
+    using Handle = std::coroutine_handle< promise_type >;
+
+    explicit Task( Handle h ) noexcept : _handle( h )
+    {
+    }
+
+    Task( Task &&other ) noexcept : _handle( std::exchange( other._handle, {} ) )
+    {
+    }
+
+    Task( const Task & ) = delete;
+    Task &operator=( const Task & ) = delete;
+    Task &operator=( Task && ) = delete;
+
+    ~Task()
+    {
+        if ( _handle )
+        {
+            _handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend( std::coroutine_handle<> awaiting ) noexcept
+    {
+        _handle.promise().continuation = awaiting;
+
+        return _handle;
+    }
+
+    T await_resume()
+    {
+        return _handle.promise().result();
+    }
+
+    void start()
+    {
+        _handle.resume();
+    }
+
+    bool done() const noexcept
+    {
+        return _handle.done();
+    }
+
+    T result()
+    {
+        return _handle.promise().result();
+    }
+
+private:
+
+    Handle _handle;
+};
+
+namespace detail
+{
+    template < class T >
+    Task< T > Promise< T >::get_return_object() noexcept
+    {
+        return Task< T >( std::coroutine_handle< Promise< T > >::from_promise( *this ) );
+    }
+
+    inline Task< void > Promise< void >::get_return_object() noexcept
+    {
+        return Task< void >( std::coroutine_handle< Promise< void > >::from_promise( *this ) );
+    }
+}
+
+/**
+ * @brief Bus transfer awaitable
+ *
+ * Suspend until the bus policy completes the transfer, resume with its status.
+ */
+template < class Bus >
+class TransferAwaiter
+{
+public:
+
+    TransferAwaiter( Bus &bus, uint8_t slave, const uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead ) noexcept
+        : _bus( bus ), _slave( slave ), _wBuffer( wBuffer ), _nWrite( nWrite ), _rBuffer( rBuffer ), _nRead( nRead ), _done { {}, false }
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend( std::coroutine_handle<> h )
+    {
+        _done.handle = h;
+
+        return _bus.submit( _slave, _wBuffer, _nWrite, _rBuffer, _nRead, _done );
+    }
+
+    bool await_resume() const noexcept
+    {
+        return _done.ok;
+    }
+
+private:
+
+    Bus             &_bus;
+    uint8_t         _slave;
+    const uint8_t   *_wBuffer;
+    uint8_t         _nWrite;
+    uint8_t         *_rBuffer;
+    uint8_t         _nRead;
+    Completion      _done;
+};
+
+/**
+ * @brief Delay awaitable
+ */
+template < class Bus >
+class DelayAwaiter
+{
+public:
+
+    DelayAwaiter( Bus &bus, uint32_t nTicks ) noexcept : _bus( bus ), _nTicks( nTicks ), _done { {}, false }
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return _nTicks == 0;
+    }
+
+    bool await_suspend( std::coroutine_handle<> h )
+    {
+        _done.handle = h;
+
+        return _bus.after( _nTicks, _done );
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+
+    Bus             &_bus;
+    uint32_t        _nTicks;
+    Completion      _done;
+};
+
+                                                                       /** @} */
+/** @defgroup PRESSURE_ASYNC_DEVICE Device */                      /** @{ */
+
+/**
+ * @brief Asynchronous sample
+ */
+struct Sample
+{
+    bool            ok;                     /**< Bus status */
+    RawSample       raw;                    /**< Raw pressure and temperature */
+};
+
+/**
+ * @brief Asynchronous pressure device
+ *
+ * @tparam Bus                          Asynchronous bus policy
+ * @tparam Address                      I2C slave address
+ *
+ * Register framing is shared with pressure::Device, every access is one
+ * submitted transfer and one suspension.
+ */
+template < class Bus, uint8_t Address = I2C_ADDRESS_1 >
+class Device
+{
+    using Frame = pressure::Device< Bus, Address >;
+
+public:
+
+    explicit Device( Bus &bus ) noexcept : _bus( bus )
+    {
+    }
+
+    Bus &bus() noexcept
+    {
+        return _bus;
+    }
+
+    /**
+     * @brief Write register, resume with true on success
+     */
+    template < uint8_t R >
+    Task< bool > write( uint8_t value )
+    {
+        uint8_t wBuffer[ 2 ] = { Frame::writeCommand( R ), value };
+        bool ok;
+
+        ok = co_await TransferAwaiter< Bus >( _bus, Address, wBuffer, 2, nullptr, 0 );
+
+        co_return ok;
+    }
+
+    /**
+     * @brief Read register, resume with true on success
+     */
+    template < uint8_t R >
+    Task< bool > read( uint8_t &value )
+    {
+        uint8_t wBuffer[ 1 ] = { Frame::readCommand( R ) };
+        bool ok;
+
+        ok = co_await TransferAwaiter< Bus >( _bus, Address, wBuffer, 1, &value, 1 );
+
+        co_return ok;
+    }
+
+    /**
+     * @brief Set register field ( read-modify-write ), resume with true on success
+     */
+    template < class F >
+    Task< bool > set( uint8_t value )
+    {
+        uint8_t temp;
+        bool ok;
+
+        ok = co_await read< F::address >( temp );
+
+        if ( !ok )
+        {
+            co_return false;
+        }
+
+        ok = co_await write< F::address >( F::insert( temp, value ) );
+
+        co_return ok;
+    }
+
+    /**
+     * @brief Default configuration ( same register values as pressure_defaultCofig )
+     */
+    Task< bool > defaultConfig()
+    {
+        bool ok;
+
+        ok = co_await write< reg::RES_CONF >( 0x78 );
+
+        if ( !ok )
+        {
+            co_return false;
+        }
+
+        ok = co_await write< reg::CTRL_REG1 >( 0xF4 );
+
+        co_return ok;
+    }
+
+    /**
+     * @brief Wait until new pressure and temperature are available
+     *
+     * @param[in] pollTicks             Bus policy ticks between STATUS_REG polls
+     *
+     * Resume with false on bus error.
+     */
+    Task< bool > waitDataReady( uint32_t pollTicks = 1 )
+    {
+        uint8_t status;
+        bool ok;
+        const uint8_t ready = field::P_DA::mask | field::T_DA::mask;
+
+        for ( ;; )
+        {
+            ok = co_await read< reg::STATUS >( status );
+
+            if ( !ok )
+            {
+                co_return false;
+            }
+
+            if ( ( status & ready ) == ready )
+            {
+                co_return true;
+            }
+
+            co_await DelayAwaiter< Bus >( _bus, pollTicks );
+        }
+    }
+
+    /**
+     * @brief Read pressure and temperature in one burst
+     *
+     * raw is zero when ok is false.
+     */
+    Task< Sample > readSample()
+    {
+        uint8_t wBuffer[ 1 ] = { Frame::burstCommand( reg::PRESS_OUT_XL ) };
+        uint8_t rBuffer[ 5 ] = {};
+        Sample sample = {};
+
+        sample.ok = co_await TransferAwaiter< Bus >( _bus, Address, wBuffer, 1, rBuffer, 5 );
+
+        if ( !sample.ok )
+        {
+            co_return sample;
+        }
+
+        sample.raw.pressure = ( ( uint32_t )rBuffer[ 2 ] << 16 ) | ( ( uint32_t )rBuffer[ 1 ] << 8 ) | rBuffer[ 0 ];
+        sample.raw.temperature = static_cast< int16_t >( ( rBuffer[ 4 ] << 8 ) | rBuffer[ 3 ] );
+
+        co_return sample;
+    }
+
+private:
+
+    Bus &_bus;
+};
+                                                                       /** @} */
+} // namespace async
+} // namespace pressure
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  __pressure_async.hpp
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
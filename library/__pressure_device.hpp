@@ -0,0 +1,413 @@
+/*
+    __pressure_device.hpp
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __pressure_device.hpp
+@brief  Pressure C++ Device
+
+Header only C++17 interface to the LPS331AP sensor on Pressure click board.
+
+Register addresses and fields are compile time constants and the device is
+templated on the bus policy and the slave address, so every register access
+folds down to one direct call of the bus policy.
+
+Bus policy requirements :
+
+@code
+struct Bus
+{
+    static constexpr bool spi = false;
+
+    //  Write nWrite bytes, then read nRead bytes ( repeated start / same CS ),
+    //  return true on success.
+    static bool transfer( uint8_t slave, const uint8_t *wBuffer, uint8_t nWrite,
+                          uint8_t *rBuffer, uint8_t nRead );
+};
+@endcode
+*/
+/* -------------------------------------------------------------------------- */
+
+#ifndef _PRESSURE_DEVICE_HPP_
+#define _PRESSURE_DEVICE_HPP_
+
+#include <stdint.h>
+
+namespace pressure
+{
+
+/** @defgroup PRESSURE_CPP_REG Register Map */                   /** @{ */
+
+namespace reg
+{
+    constexpr uint8_t REF_P_XL      = 0x08;     //  Reference pressure (LSB)
+    constexpr uint8_t REF_P_L       = 0x09;     //  Reference pressure (middle)
+    constexpr uint8_t REF_P_H       = 0x0A;     //  Reference pressure (MSB)
+    constexpr uint8_t WHO_AM_I      = 0x0F;     //  Device identification
+    constexpr uint8_t RES_CONF      = 0x10;     //  Pressure resolution
+    constexpr uint8_t CTRL_REG1     = 0x20;     //  Control register 1
+    constexpr uint8_t CTRL_REG2     = 0x21;     //  Control register 2
+    constexpr uint8_t CTRL_REG3     = 0x22;     //  Control register 3
+    constexpr uint8_t INT_CFG       = 0x23;     //  Interrupt configuration
+    constexpr uint8_t INT_SOURCE    = 0x24;     //  Interrupt source
+    constexpr uint8_t THS_P_L       = 0x25;     //  Treshold pressure (LSB)
+    constexpr uint8_t THS_P_H       = 0x26;     //  Treshold pressure (MSB)
+    constexpr uint8_t STATUS        = 0x27;     //  Status register
+    constexpr uint8_t PRESS_OUT_XL  = 0x28;     //  Pressure data (LSB)
+    constexpr uint8_t PRESS_OUT_L   = 0x29;     //  Pressure data (middle)
+    constexpr uint8_t PRESS_OUT_H   = 0x2A;     //  Pressure data (MSB)
+    constexpr uint8_t TEMP_OUT_L    = 0x2B;     //  Temperature data (LSB)
+    constexpr uint8_t TEMP_OUT_H    = 0x2C;     //  Temperature data (MSB)
+    constexpr uint8_t AMP_CTRL      = 0x30;     //  Analog front end control
+
+    constexpr uint8_t DEVICE_ID     = 0xBB;     //  WHO_AM_I value
+}
+
+constexpr uint8_t I2C_ADDRESS_0 = 0x5C;
+constexpr uint8_t I2C_ADDRESS_1 = 0x5D;
+
+/**
+ * @brief Register field type
+ *
+ * Field of width W bits at bit position S of register R.
+ */
+template <uint8_t R, uint8_t S, uint8_t W>
+struct Field
+{
+    static_assert( S + W <= 8, "field exceeds register" );
+
+    static constexpr uint8_t address = R;
+    static constexpr uint8_t shift   = S;
+    static constexpr uint8_t width   = W;
+    static constexpr uint8_t max     = ( 1u << W ) - 1u;
+    static constexpr uint8_t mask    = max << S;
+
+    static constexpr uint8_t insert( uint8_t regValue, uint8_t value )
+    {
+        return ( regValue & ~mask ) | ( ( value << S ) & mask );
+    }
+
+    static constexpr uint8_t extract( uint8_t regValue )
+    {
+        return ( regValue & mask ) >> S;
+    }
+};
+
+namespace field
+{
+    using PD        = Field< reg::CTRL_REG1, 7, 1 >;    //  Power down control
+    using ODR       = Field< reg::CTRL_REG1, 4, 3 >;    //  Output data rate
+    using DIFF_EN   = Field< reg::CTRL_REG1, 3, 1 >;    //  Interrupt circuit enable
+    using BDU       = Field< reg::CTRL_REG1, 2, 1 >;    //  Block data update
+    using DELTA_EN  = Field< reg::CTRL_REG1, 1, 1 >;    //  Delta pressure enable
+    using SIM       = Field< reg::CTRL_REG1, 0, 1 >;    //  SPI serial interface mode
+    using BOOT      = Field< reg::CTRL_REG2, 7, 1 >;    //  Reboot memory content
+    using SWRESET   = Field< reg::CTRL_REG2, 2, 1 >;    //  Software reset
+    using AUTO_ZERO = Field< reg::CTRL_REG2, 1, 1 >;    //  Autozero enable
+    using ONE_SHOT  = Field< reg::CTRL_REG2, 0, 1 >;    //  One shot enable
+    using INT_H_L   = Field< reg::CTRL_REG3, 7, 1 >;    //  Interrupt active high/low
+    using PP_OD     = Field< reg::CTRL_REG3, 6, 1 >;    //  Push-pull/open drain
+    using INT2_S    = Field< reg::CTRL_REG3, 3, 3 >;    //  INT2 signal select
+    using INT1_S    = Field< reg::CTRL_REG3, 0, 3 >;    //  INT1 signal select
+    using AVGT      = Field< reg::RES_CONF,  4, 3 >;    //  Temperature averaging
+    using AVGP      = Field< reg::RES_CONF,  0, 4 >;    //  Pressure averaging
+    using LIR       = Field< reg::INT_CFG,   2, 1 >;    //  Latch interrupt request
+    using PL_E      = Field< reg::INT_CFG,   1, 1 >;    //  Pressure low interrupt enable
+    using PH_E      = Field< reg::INT_CFG,   0, 1 >;    //  Pressure high interrupt enable
+    using P_DA      = Field< reg::STATUS,    1, 1 >;    //  Pressure data available
+    using T_DA      = Field< reg::STATUS,    0, 1 >;    //  Temperature data available
+    using SELMAIN   = Field< reg::AMP_CTRL,  0, 1 >;    //  Current of the main amplifier
+}
+
+                                                                       /** @} */
+/** @defgroup PRESSURE_CPP_CONV Conversion */                     /** @{ */
+
+/**
+ * @brief Raw pressure to mbar
+ */
+constexpr float rawToPressure( uint32_t raw )
+{
+    return raw * 0.000244140625f;
+}
+
+/**
+ * @brief Raw temperature to degrees Celsius
+ */
+constexpr float rawToTemperature( int16_t raw )
+{
+    return raw * 0.00208333333f + 42.5f;
+}
+
+/**
+ * @brief Raw pressure to Pa ( rounded )
+ */
+constexpr uint32_t rawToPascal( uint32_t raw )
+{
+    return ( ( raw & 0x00FFFFFFu ) * 25u + 512u ) >> 10;
+}
+
+/**
+ * @brief Raw temperature to centi degrees Celsius ( rounded )
+ */
+constexpr int16_t rawToCentiCelsius( int16_t raw )
+{
+    //  ( t * 5 / 24 + 4250 ), biased by 24 * 6827 to keep the dividend positive
+    return static_cast< int16_t >( static_cast< uint32_t >( raw * 5L + 163848L + 12L ) / 24u ) - 2577;
+}
+
+static_assert( rawToPascal( 4096ul * 1013ul ) == 101300ul, "pressure conversion" );
+static_assert( rawToCentiCelsius( 0 ) == 4250, "temperature conversion" );
+
+/**
+ * @brief Raw sample
+ */
+struct RawSample
+{
+    uint32_t    pressure;                   /**< 24-bit raw pressure */
+    int16_t     temperature;                /**< 16-bit raw temperature */
+};
+
+                                                                       /** @} */
+/** @defgroup PRESSURE_CPP_DEVICE Device */                       /** @{ */
+
+/**
+ * @brief Pressure device
+ *
+ * @tparam Bus                          Bus policy
+ * @tparam Address                      I2C slave address ( passed to the bus policy unchanged for SPI )
+ *
+ * Stateless, all register addresses and register byte framing are resolved at compile time.
+ */
+template < class Bus, uint8_t Address = I2C_ADDRESS_1 >
+class Device
+{
+public:
+
+    static constexpr uint8_t address = Address;
+
+    /**
+     * @brief Register byte for the single register read
+     */
+    static constexpr uint8_t readCommand( uint8_t regAddress )
+    {
+        return Bus::spi ? ( ( regAddress & 0x3F ) | 0x80 ) : regAddress;
+    }
+
+    /**
+     * @brief Register byte for the auto increment burst read
+     */
+    static constexpr uint8_t burstCommand( uint8_t regAddress )
+    {
+        return Bus::spi ? ( regAddress | 0xC0 ) : ( regAddress | 0x80 );
+    }
+
+    /**
+     * @brief Register byte for the write
+     */
+    static constexpr uint8_t writeCommand( uint8_t regAddress )
+    {
+        return Bus::spi ? ( regAddress & 0x3F ) : regAddress;
+    }
+
+    /**
+     * @brief Write register, return true on success
+     */
+    template < uint8_t R >
+    static bool write( uint8_t value )
+    {
+        const uint8_t wBuffer[ 2 ] = { writeCommand( R ), value };
+
+        return Bus::transfer( Address, wBuffer, 2, nullptr, 0 );
+    }
+
+    /**
+     * @brief Read register, return true on success
+     */
+    template < uint8_t R >
+    static bool read( uint8_t &value )
+    {
+        const uint8_t wBuffer[ 1 ] = { readCommand( R ) };
+
+        return Bus::transfer( Address, wBuffer, 1, &value, 1 );
+    }
+
+    /**
+     * @brief Burst read of N registers starting at R, return true on success
+     */
+    template < uint8_t R, uint8_t N >
+    static bool read( uint8_t ( &buffer )[ N ] )
+    {
+        const uint8_t wBuffer[ 1 ] = { N > 1 ? burstCommand( R ) : readCommand( R ) };
+
+        return Bus::transfer( Address, wBuffer, 1, buffer, N );
+    }
+
+    /**
+     * @brief Set register field ( read-modify-write ), return true on success
+     */
+    template < class F >
+    static bool set( uint8_t value )
+    {
+        uint8_t temp;
+
+        if ( !read< F::address >( temp ) )
+        {
+            return false;
+        }
+
+        return write< F::address >( F::insert( temp, value ) );
+    }
+
+    /**
+     * @brief Get register field, return true on success
+     */
+    template < class F >
+    static bool get( uint8_t &value )
+    {
+        uint8_t temp;
+        bool ok;
+
+        ok = read< F::address >( temp );
+        value = F::extract( temp );
+
+        return ok;
+    }
+
+    /**
+     * @brief Check device identification
+     */
+    static bool probe()
+    {
+        uint8_t id;
+
+        return read< reg::WHO_AM_I >( id ) && id == reg::DEVICE_ID;
+    }
+
+    /**
+     * @brief Default configuration ( same register values as pressure_defaultCofig )
+     */
+    static bool defaultConfig()
+    {
+        return write< reg::RES_CONF >( 0x78 ) && write< reg::CTRL_REG1 >( 0xF4 );
+    }
+
+    /**
+     * @brief Check data available flags
+     */
+    static bool dataReady( bool &ready )
+    {
+        uint8_t status;
+        bool ok;
+
+        ok = read< reg::STATUS >( status );
+        ready = ( status & ( field::P_DA::mask | field::T_DA::mask ) ) == ( field::P_DA::mask | field::T_DA::mask );
+
+        return ok;
+    }
+
+    /**
+     * @brief Read pressure and temperature in one burst
+     *
+     * sample is left untouched when the read fails.
+     */
+    static bool readRaw( RawSample &sample )
+    {
+        uint8_t buffer[ 5 ] = {};
+
+        if ( !read< reg::PRESS_OUT_XL, 5 >( buffer ) )
+        {
+            return false;
+        }
+
+        sample.pressure = ( ( uint32_t )buffer[ 2 ] << 16 ) | ( ( uint32_t )buffer[ 1 ] << 8 ) | buffer[ 0 ];
+        sample.temperature = static_cast< int16_t >( ( buffer[ 4 ] << 8 ) | buffer[ 3 ] );
+
+        return true;
+    }
+
+    /**
+     * @brief Read pressure in mbar
+     */
+    static bool readPressure( float &pressure )
+    {
+        RawSample sample;
+
+        if ( !readRaw( sample ) )
+        {
+            return false;
+        }
+
+        pressure = rawToPressure( sample.pressure );
+
+        return true;
+    }
+
+    /**
+     * @brief Read temperature in degrees Celsius
+     */
+    static bool readTemperature( float &temperature )
+    {
+        RawSample sample;
+
+        if ( !readRaw( sample ) )
+        {
+            return false;
+        }
+
+        temperature = rawToTemperature( sample.temperature );
+
+        return true;
+    }
+};
+                                                                       /** @} */
+} // namespace pressure
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  __pressure_device.hpp
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
@@ -16,6 +16,15 @@
 
 /* ------------------------------------------------------------------- MACROS */
 
+//  vector paths of pressure_convertBlock(), x86 host and gateway targets only
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#define _PRESSURE_BLOCK_LANES   8
+#elif defined( __SSSE3__ )
+#include <tmmintrin.h>
+#define _PRESSURE_BLOCK_LANES   4
+#endif
+
 
 
 /* ---------------------------------------------------------------- VARIABLES */
@@ -25,6 +34,107 @@ static uint8_t _slaveAddress;
 #endif
 
 static uint8_t pressureInterfaceSelect;
+static T_PRESSURE_P _gpioObj;
+static T_PRESSURE_P _busObj;
+
+static uint8_t _retryBudget = 2;
+static uint8_t _lastError;
+static T_pressure_busStats _busStats;
+
+static T_pressure_tickFp _tickSource;
+static uint8_t _timestampMode;
+static uint8_t _intTimestampValid;
+static uint32_t _intTimestamp;
+
+static uint8_t _lastTimestampValid;
+static uint32_t _lastTimestamp;
+static uint32_t _jitterCount;
+static uint32_t _jitterMin;
+static uint32_t _jitterMax;
+static float _jitterMean;
+static float _jitterM2;
+
+#ifdef   __PRESSURE_LATENCY__
+static uint8_t _lastIntState;
+static uint8_t _readyTickValid;
+static uint32_t _readyTick;
+static uint16_t _latReadyToRead[ _PRESSURE_LATENCY_BUCKETS ];
+static uint16_t _latReadToConsume[ _PRESSURE_LATENCY_BUCKETS ];
+static uint16_t _latReadyToConsume[ _PRESSURE_LATENCY_BUCKETS ];
+#endif
+
+#ifdef   __PRESSURE_SCHEDULER__
+static T_pressure_taskFp _schedTaskFp[ _PRESSURE_SCHED_MAX_TASKS ];
+static uint32_t _schedPeriod[ _PRESSURE_SCHED_MAX_TASKS ];
+static uint32_t _schedDeadline[ _PRESSURE_SCHED_MAX_TASKS ];
+static uint32_t _schedRelease[ _PRESSURE_SCHED_MAX_TASKS ];
+static uint8_t _schedReleased[ _PRESSURE_SCHED_MAX_TASKS ];
+static T_pressure_taskStats _schedStats[ _PRESSURE_SCHED_MAX_TASKS ];
+static uint8_t _schedNTasks;
+static T_pressure_sleepFp _schedSleepFp;
+static uint32_t _schedIdleTicks;
+#endif
+
+static uint8_t _profileApplied = 0xFF;
+
+#ifdef   __PRESSURE_TRACE__
+static T_pressure_traceFp _traceSink;
+static uint8_t _traceIntLevel;
+#endif
+
+#ifdef   __PRESSURE_CALIBRATION__
+static T_pressure_calibration _calibration = { 0, 0x4000, 0, 0 };
+static T_pressure_calFp _calLoadFp;
+static T_pressure_calFp _calStoreFp;
+static float _calScale = 0.000244140625f;
+static uint32_t _calFactor = 409600;
+static uint8_t _calSet;
+#endif
+
+#ifdef   __PRESSURE_BUS_ARBITER__
+static T_pressure_arbiter _arbiter;
+static T_pressure_arbStats _arbStats;
+#endif
+
+#ifdef   __PRESSURE_TXN_QUEUE__
+static T_pressure_queueEntry _queue[ _PRESSURE_QUEUE_SIZE ];
+static T_pressure_queueStats _queueStats;
+static uint32_t _queuePeriod;
+static uint8_t _cacheData[ _PRESSURE_QUEUE_CACHE ][ _PRESSURE_QUEUE_MAX_BYTES ];
+static uint8_t _cacheReg[ _PRESSURE_QUEUE_CACHE ];
+static uint8_t _cacheLen[ _PRESSURE_QUEUE_CACHE ];
+static uint8_t _cacheValid[ _PRESSURE_QUEUE_CACHE ];
+static uint32_t _cacheTick[ _PRESSURE_QUEUE_CACHE ];
+static uint8_t _cacheNext;
+#endif
+
+#ifdef   __PRESSURE_DRV_UART__
+static uint8_t _txRing[ _PRESSURE_STREAM_RING_SIZE ];
+static volatile uint8_t _txHead;
+static volatile uint8_t _txTail;
+static uint8_t _txSequence;
+static uint8_t _rxFrame[ 4 + _PRESSURE_STREAM_MAX_PAYLOAD ];
+static uint8_t _rxCount;
+static T_pressure_streamStats _streamStats;
+#endif
+
+#ifdef   __PRESSURE_IDLE__
+static uint32_t _idleTimeout;
+static uint8_t _idleAsleep;
+static uint32_t _idleLastRead;
+static uint32_t _idleSince;
+static T_pressure_idleStats _idleStats;
+#endif
+
+#ifdef   __PRESSURE_BATCH__
+static T_pressure_sample _batch[ _PRESSURE_BATCH_SIZE ];
+static uint8_t _batchCount;
+static uint8_t _batchSource;
+static uint8_t _batchWatermark = 1;
+static uint32_t _batchMaxAge;
+static T_pressure_batchFp _batchFp;
+static T_pressure_batchStats _batchStats;
+#endif
 
 const uint8_t _PRESSURE_I2C_SELECT                                  = 0;
 const uint8_t _PRESSURE_SPI_SELECT                                  = 1;
@@ -62,419 +172,4051 @@ const uint8_t _PRESSURE_AMP_CTRL                                    = 0x30;
 const uint8_t _PRESSURE_I2C_ADDRESS_0                               = 0x5C;
 const uint8_t _PRESSURE_I2C_ADDRESS_1                               = 0x5D;                 //  Slave address
 
-/* -------------------------------------------- PRIVATE FUNCTION DECLARATIONS */
-
-
+const uint8_t _PRESSURE_OK                                          = 0;
+const uint8_t _PRESSURE_ERR_BUS                                     = 1;
+const uint8_t _PRESSURE_ERR_PARAM                                   = 2;
+const uint8_t _PRESSURE_ERR_VERIFY                                  = 3;
 
-/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
-
-
-
-/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+const uint8_t _PRESSURE_TIMESTAMP_AT_READ                           = 0;
+const uint8_t _PRESSURE_TIMESTAMP_AT_INT                            = 1;
 
-#ifdef   __PRESSURE_DRV_SPI__
+#ifdef   __PRESSURE_SCHEDULER__
+const uint8_t _PRESSURE_SCHED_NO_TASK                               = 0xFF;
+const uint32_t _PRESSURE_SCHED_UNTIL_INT                            = 0xFFFFFFFF;
+#endif
+#ifdef   __PRESSURE_TXN_QUEUE__
+const uint8_t _PRESSURE_QUEUE_NO_SLOT                               = 0xFF;
+#endif
 
-void pressure_spiDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P spiObj)
+const uint8_t _PRESSURE_FIELD_PD                                    = 0;                    //  Power down control
+const uint8_t _PRESSURE_FIELD_ODR                                   = 1;                    //  Output data rate
+const uint8_t _PRESSURE_FIELD_DIFF_EN                               = 2;                    //  Interrupt circuit enable
+const uint8_t _PRESSURE_FIELD_BDU                                   = 3;                    //  Block data update
+const uint8_t _PRESSURE_FIELD_DELTA_EN                              = 4;                    //  Delta pressure enable
+const uint8_t _PRESSURE_FIELD_SIM                                   = 5;                    //  SPI serial interface mode
+const uint8_t _PRESSURE_FIELD_BOOT                                  = 6;                    //  Reboot memory content
+const uint8_t _PRESSURE_FIELD_SWRESET                               = 7;                    //  Software reset
+const uint8_t _PRESSURE_FIELD_AUTO_ZERO                             = 8;                    //  Autozero enable
+const uint8_t _PRESSURE_FIELD_ONE_SHOT                              = 9;                    //  One shot enable
+const uint8_t _PRESSURE_FIELD_INT_H_L                               = 10;                   //  Interrupt active high/low
+const uint8_t _PRESSURE_FIELD_PP_OD                                 = 11;                   //  Push-pull/open drain
+const uint8_t _PRESSURE_FIELD_INT2_S                                = 12;                   //  INT2 signal select
+const uint8_t _PRESSURE_FIELD_INT1_S                                = 13;                   //  INT1 signal select
+const uint8_t _PRESSURE_FIELD_AVGT                                  = 14;                   //  Temperature averaging
+const uint8_t _PRESSURE_FIELD_AVGP                                  = 15;                   //  Pressure averaging
+const uint8_t _PRESSURE_FIELD_LIR                                   = 16;                   //  Latch interrupt request
+const uint8_t _PRESSURE_FIELD_PL_E                                  = 17;                   //  Pressure low interrupt enable
+const uint8_t _PRESSURE_FIELD_PH_E                                  = 18;                   //  Pressure high interrupt enable
+const uint8_t _PRESSURE_FIELD_SELMAIN                               = 19;                   //  Current of the main amplifier
+
+//  Register address, shift, width
+static const T_pressure_fieldDesc _PRESSURE_FIELDS[ 20 ] =
 {
-    pressureInterfaceSelect = _PRESSURE_SPI_SELECT;
-    hal_spiMap( (T_HAL_P)spiObj );
-    hal_gpioMap( (T_HAL_P)gpioObj );
+    { 0x20, 7, 1 },
+    { 0x20, 4, 3 },
+    { 0x20, 3, 1 },
+    { 0x20, 2, 1 },
+    { 0x20, 1, 1 },
+    { 0x20, 0, 1 },
+    { 0x21, 7, 1 },
+    { 0x21, 2, 1 },
+    { 0x21, 1, 1 },
+    { 0x21, 0, 1 },
+    { 0x22, 7, 1 },
+    { 0x22, 6, 1 },
+    { 0x22, 3, 3 },
+    { 0x22, 0, 3 },
+    { 0x10, 4, 3 },
+    { 0x10, 0, 4 },
+    { 0x23, 2, 1 },
+    { 0x23, 1, 1 },
+    { 0x23, 0, 1 },
+    { 0x30, 0, 1 }
+};
+
+const uint8_t _PRESSURE_PROFILE_ULTRA_LOW_POWER                     = 0;
+const uint8_t _PRESSURE_PROFILE_BALANCED                            = 1;
+const uint8_t _PRESSURE_PROFILE_HIGH_RESOLUTION                     = 2;
+const uint8_t _PRESSURE_PROFILE_HIGH_RATE                           = 3;
+
+//  ODR, RES_CONF, AMP_CTRL, estimated uA, estimated mbar RMS
+static const T_pressure_profileInfo _PRESSURE_PROFILES[ 4 ] =
+{
+    { 1, 0x00, 0x00,  5.5, 0.45 },
+    { 2, 0x45, 0x00, 18.0, 0.08 },
+    { 1, 0x7A, 0x00, 30.0, 0.02 },
+    { 7, 0x35, 0x01, 44.0, 0.08 }
+};
 
-    hal_gpio_csSet( 0 );
-}
+#ifdef   __PRESSURE_DRV_UART__
+const uint8_t _PRESSURE_FRAME_SYNC                                  = 0xA5;
+const uint8_t _PRESSURE_FRAME_SAMPLE                                = 0x01;                 //  Raw image of _PRESSURE_PRESS_POUT_XLB_REH .. _PRESSURE_TEMP_OUT_MSB
+const uint8_t _PRESSURE_FRAME_ACK                                   = 0x02;                 //  Command type, status
+const uint8_t _PRESSURE_CMD_SET_ODR                                 = 0x81;                 //  Output data rate code
+const uint8_t _PRESSURE_CMD_SET_PROFILE                             = 0x82;                 //  Power profile
+#endif
 
+#ifdef   __PRESSURE_RESAMPLER__
+const uint8_t _PRESSURE_RESAMPLE_LINEAR                             = 0;
+const uint8_t _PRESSURE_RESAMPLE_CUBIC                              = 1;
 #endif
-#ifdef   __PRESSURE_DRV_I2C__
 
-void pressure_i2cDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P i2cObj, uint8_t slave)
-{
-    _slaveAddress = slave;
-    pressureInterfaceSelect = _PRESSURE_I2C_SELECT;
-    hal_i2cMap( (T_HAL_P)i2cObj );
-    hal_gpioMap( (T_HAL_P)gpioObj );
+#ifdef   __PRESSURE_BATCH__
+const uint8_t _PRESSURE_BATCH_POLL_STATUS                           = 0;
+const uint8_t _PRESSURE_BATCH_POLL_INT                              = 1;
+#endif
 
-    // ... power ON
-    // ... configure CHIP
-}
+/* -------------------------------------------- PRIVATE FUNCTION DECLARATIONS */
 
+static uint32_t _getTick();
+#ifdef   _PRESSURE_BLOCK_LANES
+static size_t _blockPressure( const uint8_t *raw, size_t nSamples, float *outP );
+static size_t _blockTemperature( const uint8_t *raw, size_t nSamples, float *outT );
+#endif
+static uint8_t _intGet();
+static uint8_t _busSequence( uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead );
+static void _arbLock();
+static void _arbUnlock();
+static uint8_t _transfer( uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead );
+static uint8_t _regWrite( uint8_t regAddress, uint8_t writeData );
+static uint8_t _regRead( uint8_t regAddress, uint8_t *rBuffer, uint8_t nBytes );
+static uint8_t _setField( uint8_t field, uint8_t value );
+static uint8_t _setConfiguration( uint8_t configVal );
+static uint8_t _warmStart( T_pressure_config *cfg );
+static uint8_t _setPowerProfile( uint8_t profile );
+#ifdef   __PRESSURE_BUS_RECOVERY__
+static uint8_t _busRecover();
+#endif
+static void _updateJitter( uint32_t timestamp );
+#ifdef   __PRESSURE_LATENCY__
+static void _latencyAdd( uint16_t *histogram, uint32_t latency );
+static void _latencyPrint( T_pressure_putsFp putsFp, char *name, uint16_t *histogram );
+#endif
+#ifdef   __PRESSURE_SCHEDULER__
+static uint8_t _schedAdd( T_pressure_taskFp taskFp, uint32_t period, uint32_t deadline );
+#endif
+#ifdef   __PRESSURE_TRACE__
+static void _traceRecord( uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead, uint8_t err );
+#ifndef  __PRESSURE_HAL_REPLAY__
+static void _traceInt( uint8_t level );
+#endif
+#endif
+#ifdef   __PRESSURE_STATS__
+static float _sqrt( float x );
+static void _wideMul( uint32_t a, uint32_t b, uint32_t *hi, uint32_t *lo );
+static void _wideMulSigned( int32_t a, uint32_t xHi, uint32_t xLo, uint32_t *hi, uint32_t *lo );
+static void _wideAdd( uint32_t *hi, uint32_t *lo, uint32_t addHi, uint32_t addLo );
+static void _wideSub( uint32_t *hi, uint32_t *lo, uint32_t subHi, uint32_t subLo );
+static float _wideFloat( uint32_t hi, uint32_t lo );
+static void _statsResult( T_pressure_stats *stats, T_pressure_statsResult *result, float scale, float offset );
+#endif
+#ifdef   __PRESSURE_DECIMATOR__
+static void _decimatorRestart( T_pressure_decimator *dec, int32_t reference );
+#endif
+#ifdef   __PRESSURE_CALIBRATION__
+static uint32_t _calCorrect( uint32_t rawPressure, int16_t rawTemperature );
+static uint32_t _calApply( uint32_t rawPressure, int16_t rawTemperature );
+#endif
+static uint8_t _probeOne( T_pressure_probeEntry *entry );
+static uint8_t _warmWrite( uint8_t regAddress, uint8_t current, uint8_t desired );
+#ifdef   __PRESSURE_TXN_QUEUE__
+static uint8_t _queueComplete( uint8_t entry, uint8_t err, uint32_t now );
 #endif
 #ifdef   __PRESSURE_DRV_UART__
+static uint8_t _crc8( uint8_t crc, uint8_t *buffer, uint8_t nBytes );
+static uint8_t _streamFrame( uint8_t frameType, uint8_t *payload, uint8_t nPayload );
+static void _streamCommand();
+#endif
+#ifdef   __PRESSURE_IDLE__
+static void _idleTouch();
+#endif
+#ifdef   __PRESSURE_RESAMPLER__
+static int32_t _mulFrac( int32_t value, uint16_t fraction );
+#endif
+#ifdef   __PRESSURE_RATE__
+static uint32_t _mulQ24( uint32_t a, uint32_t k );
+#endif
+#ifdef   __PRESSURE_MEDIAN__
+static uint8_t _medianLess( T_pressure_median *mf, uint8_t i, uint8_t j );
+static uint8_t _medianSwap( T_pressure_median *mf, uint8_t i, uint8_t j );
+static void _medianMinDown( T_pressure_median *mf, uint8_t k );
+static void _medianMaxDown( T_pressure_median *mf, uint8_t k );
+static uint8_t _medianMinUp( T_pressure_median *mf, uint8_t k );
+static uint8_t _medianMaxUp( T_pressure_median *mf, uint8_t k );
+#endif
 
-void pressure_uartDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P uartObj)
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint32_t _getTick()
 {
-    hal_uartMap( (T_HAL_P)uartObj );
-    hal_gpioMap( (T_HAL_P)gpioObj );
+    if ( _tickSource == 0 )
+    {
+        return 0;
+    }
 
-    // ... power ON
-    // ... configure CHIP
+    return _tickSource();
 }
 
+static uint8_t _intGet()
+{
+#ifdef   __PRESSURE_HAL_REPLAY__
+    return hal_replayInt();
+#else
+    uint8_t level;
+
+    level = hal_gpio_intGet();
+#ifdef   __PRESSURE_TRACE__
+    if ( level != _traceIntLevel )
+    {
+        _traceIntLevel = level;
+        _traceInt( level );
+    }
 #endif
 
+    return level;
+#endif
+}
 
-
-/* ----------------------------------------------------------- IMPLEMENTATION */
-
-
-
-/* Generic write the byte of data function */
-void pressure_writeData( uint8_t regAddress, uint8_t writeData )
+static uint8_t _busSequence( uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead )
 {
-    uint8_t wBuffer[ 2 ];
-
-    wBuffer[ 0 ] = regAddress;
-    wBuffer[ 1 ] = writeData;
-
     if ( pressureInterfaceSelect == _PRESSURE_SPI_SELECT )
     {
-        wBuffer[ 0 ] &= 0x3F;
-
         hal_gpio_csSet( 0 );
-        hal_spiWrite( wBuffer, 2 );
+        hal_spiWrite( wBuffer, nWrite );
+        if ( nRead != 0 )
+        {
+            hal_spiRead( rBuffer, nRead );
+        }
         hal_gpio_csSet( 1 );
+
+        return _PRESSURE_OK;
     }
-    else
+
+    if ( hal_i2cStart() != 0 )
     {
-        hal_i2cStart();
-        hal_i2cWrite( _slaveAddress, wBuffer, 2, END_MODE_STOP );
+        return _PRESSURE_ERR_BUS;
     }
-}
 
-/* Generic read the byte of data function*/
-uint8_t pressure_readData( uint8_t regAddress )
-{
-    uint8_t wBuffer[ 1 ];
-    uint8_t rBuffer[ 1 ];
+    if ( nRead == 0 )
+    {
+        if ( hal_i2cWrite( _slaveAddress, wBuffer, nWrite, END_MODE_STOP ) != 0 )
+        {
+            return _PRESSURE_ERR_BUS;
+        }
 
-    wBuffer[ 0 ] = regAddress;
+        return _PRESSURE_OK;
+    }
 
-    if ( pressureInterfaceSelect == _PRESSURE_SPI_SELECT )
+    if ( hal_i2cWrite( _slaveAddress, wBuffer, nWrite, END_MODE_RESTART ) != 0 )
     {
-        wBuffer[ 0 ] &= 0xBF;
-
-        hal_gpio_csSet( 0 );
-        hal_spiWrite( wBuffer, 1 );
-        hal_spiRead( rBuffer, 1 );
-        hal_gpio_csSet( 1 );
+        return _PRESSURE_ERR_BUS;
     }
-    else
+
+    if ( hal_i2cRead( _slaveAddress, rBuffer, nRead, END_MODE_STOP ) != 0 )
     {
-        hal_i2cStart();
-        hal_i2cWrite( _slaveAddress, wBuffer, 1, END_MODE_RESTART );
-        hal_i2cRead( _slaveAddress, rBuffer, 1, END_MODE_STOP );
+        return _PRESSURE_ERR_BUS;
     }
 
-    return rBuffer[ 0 ];
+    return _PRESSURE_OK;
 }
 
-/* Device ID read function */
-uint8_t pressure_readID()
+static void _arbLock()
 {
-    uint8_t temp;
+#ifdef   __PRESSURE_BUS_ARBITER__
+    uint8_t contended;
+    uint32_t waitTicks;
 
-    temp = pressure_readData( _PRESSURE_DEVICE_ID_REG );
-
-    return temp;
-}
+    if ( _arbiter.lock == 0 )
+    {
+        return;
+    }
 
-/* Set configuration function*/
-void pressure_setConfiguration( uint8_t configVal )
-{
-    uint8_t temp;
+    contended = 0;
+    waitTicks = 0;
 
-    temp = pressure_readData( _PRESSURE_RES_CONFIG );
+    if ( _arbiter.tryLock == 0 || _arbiter.tryLock() == 0 )
+    {
+        contended = ( _arbiter.tryLock != 0 );
+        waitTicks = _getTick();
 
-    temp |= configVal;
+        if ( contended && _arbiter.inherit != 0 )
+        {
+            _arbiter.inherit();
+        }
 
-    pressure_writeData( _PRESSURE_RES_CONFIG, temp );
-}
+        _arbiter.lock();
 
-/* Get configuration function*/
-uint8_t pressure_getConfiguration()
-{
-    uint8_t temp;
+        waitTicks = _getTick() - waitTicks;
+    }
 
-    temp = pressure_readData( _PRESSURE_RES_CONFIG );
+    //  counters are updated only while the lock is held
+    _arbStats.acquisitions++;
+    _arbStats.contentions += contended;
+    _arbStats.waitTicks += waitTicks;
 
-    return temp;
+    if ( waitTicks > _arbStats.maxWaitTicks )
+    {
+        _arbStats.maxWaitTicks = waitTicks;
+    }
+#endif
 }
 
-/* Enable the device function*/
-void pressure_enable()
+static void _arbUnlock()
 {
-    uint8_t temp;
-
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+#ifdef   __PRESSURE_BUS_ARBITER__
+    if ( _arbiter.lock == 0 )
+    {
+        return;
+    }
 
-    temp |= 0x80;
+    _arbiter.unlock();
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    if ( _arbiter.restore != 0 )
+    {
+        _arbiter.restore();
+    }
+#endif
 }
 
-/* Disable the device function*/
-void pressure_powerDown()
+//  called with the bus lock held, retries and recovery stay inside the same lock
+static uint8_t _transfer( uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead )
 {
-    uint8_t temp;
+    uint8_t err;
+    uint8_t nRetries;
+    uint32_t startTick;
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    _busStats.transactions++;
 
-    temp &= 0x7F;
+    //  error time includes the first failed attempt
+    startTick = _getTick();
+    err = _busSequence( wBuffer, nWrite, rBuffer, nRead );
+#ifdef   __PRESSURE_TRACE__
+    _traceRecord( wBuffer, nWrite, rBuffer, nRead, err );
+#endif
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
-}
+    if ( err == _PRESSURE_OK )
+    {
+        return err;
+    }
 
-/* Set output data rate function*/
-void pressure_setOutputDataRate( uint8_t outDataRate )
-{
-    uint8_t temp;
+    nRetries = 0;
 
-    outDataRate %= 8;
-    outDataRate <<= 4;
+    while ( err != _PRESSURE_OK && nRetries < _retryBudget )
+    {
+        nRetries++;
+        _busStats.retries++;
+#ifdef   __PRESSURE_BUS_RECOVERY__
+        _busRecover();
+#endif
+        err = _busSequence( wBuffer, nWrite, rBuffer, nRead );
+#ifdef   __PRESSURE_TRACE__
+        _traceRecord( wBuffer, nWrite, rBuffer, nRead, err );
+#endif
+    }
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    _busStats.errorTicks += _getTick() - startTick;
 
-    temp &= 0x8F;
-    temp |= outDataRate;
+    if ( err != _PRESSURE_OK )
+    {
+        _busStats.errors++;
+        _lastError = err;
+
+        while ( nRead != 0 )
+        {
+            nRead--;
+            rBuffer[ nRead ] = 0;
+        }
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    return err;
 }
 
-/* Enable interrupt circuit function*/
-void pressure_enableInterruptCircuit()
+static uint8_t _regWrite( uint8_t regAddress, uint8_t writeData )
 {
-    uint8_t temp;
+    uint8_t wBuffer[ 2 ];
+#ifdef   __PRESSURE_TXN_QUEUE__
+    uint8_t entry;
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    for ( entry = 0; entry < _PRESSURE_QUEUE_CACHE; entry++ )
+    {
+        if ( regAddress >= _cacheReg[ entry ] && regAddress < _cacheReg[ entry ] + _cacheLen[ entry ] )
+        {
+            _cacheValid[ entry ] = 0;
+        }
+    }
+#endif
+
+    wBuffer[ 0 ] = regAddress;
+    wBuffer[ 1 ] = writeData;
 
-    temp |= 0x08;
+    if ( pressureInterfaceSelect == _PRESSURE_SPI_SELECT )
+    {
+        wBuffer[ 0 ] &= 0x3F;
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    return _transfer( wBuffer, 2, 0, 0 );
 }
 
-/* Disable interrupt function*/
-void pressure_disableInterrupt()
+static uint8_t _regRead( uint8_t regAddress, uint8_t *rBuffer, uint8_t nBytes )
 {
-    uint8_t temp;
+    uint8_t wBuffer[ 1 ];
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    wBuffer[ 0 ] = regAddress;
 
-    temp &= 0xF7;
+    //  address auto increment only for bursts
+    if ( pressureInterfaceSelect == _PRESSURE_SPI_SELECT )
+    {
+        wBuffer[ 0 ] &= 0x3F;
+        wBuffer[ 0 ] |= nBytes > 1 ? 0xC0 : 0x80;
+    }
+    else if ( nBytes > 1 )
+    {
+        wBuffer[ 0 ] |= 0x80;
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    return _transfer( wBuffer, 1, rBuffer, nBytes );
 }
 
-/* Enable block data update function*/
-void pressure_blockDataUpdate()
+#ifdef   __PRESSURE_BUS_RECOVERY__
+static uint8_t _busRecover()
 {
-    uint8_t temp;
+    uint8_t nPulses;
+    uint8_t sda;
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    for ( nPulses = 0; nPulses < 9; nPulses++ )
+    {
+        if ( hal_gpio_sdaGet() != 0 )
+        {
+            break;
+        }
+
+        hal_gpio_sclSet( 0 );
+        Delay_5us();
+        hal_gpio_sclSet( 1 );
+        Delay_5us();
+    }
+
+    sda = hal_gpio_sdaGet();
+
+    if ( nPulses != 0 && sda != 0 )
+    {
+        //  STOP condition : SDA rising while SCL is high
+        hal_gpio_sclSet( 0 );
+        Delay_5us();
+        hal_gpio_sdaSet( 0 );
+        Delay_5us();
+        hal_gpio_sclSet( 1 );
+        Delay_5us();
+        hal_gpio_sdaSet( 1 );
+        Delay_5us();
+
+        _busStats.recoveries++;
+    }
 
-    temp |= 0x04;
+    if ( sda == 0 )
+    {
+        return _PRESSURE_ERR_BUS;
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    return _PRESSURE_OK;
 }
+#endif
 
-/* Disable block data - continuous update function*/
-void pressure_unblockDataUpdate()
+static void _updateJitter( uint32_t timestamp )
 {
-    uint8_t temp;
-
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    uint32_t interval;
+    float delta;
 
-    temp &= 0xFB;
+    if ( _lastTimestampValid )
+    {
+        interval = timestamp - _lastTimestamp;
+
+        if ( _jitterCount == 0 || interval < _jitterMin )
+        {
+            _jitterMin = interval;
+        }
+        if ( interval > _jitterMax )
+        {
+            _jitterMax = interval;
+        }
+
+        _jitterCount++;
+        delta = ( float ) interval - _jitterMean;
+        _jitterMean += delta / ( float ) _jitterCount;
+        _jitterM2 += delta * ( ( float ) interval - _jitterMean );
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    _lastTimestamp = timestamp;
+    _lastTimestampValid = 1;
 }
 
-/* Delta pressure enable function */
-void pressure_enableDeltaPressure()
+#ifdef   __PRESSURE_LATENCY__
+static void _latencyAdd( uint16_t *histogram, uint32_t latency )
 {
-    uint8_t temp;
+    uint8_t bucket;
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    bucket = 0;
 
-    temp |= 0x02;
+    while ( latency != 0 && bucket < _PRESSURE_LATENCY_BUCKETS - 1 )
+    {
+        latency >>= 1;
+        bucket++;
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    if ( histogram[ bucket ] != 0xFFFF )
+    {
+        histogram[ bucket ]++;
+    }
 }
 
-/* Delta pressure disable function*/
-void pressure_disableDeltaPressure()
+static void _latencyPrint( T_pressure_putsFp putsFp, char *name, uint16_t *histogram )
 {
-    uint8_t temp;
-
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
-
-    temp &= 0xFD;
+    char line[ 24 ];
+    uint8_t bucket;
+    uint8_t pos;
+    uint8_t nDigits;
+    uint16_t count;
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    for ( bucket = 0; bucket < _PRESSURE_LATENCY_BUCKETS; bucket++ )
+    {
+        if ( histogram[ bucket ] == 0 )
+        {
+            continue;
+        }
+
+        pos = 0;
+        while ( name[ pos ] != 0 )
+        {
+            line[ pos ] = name[ pos ];
+            pos++;
+        }
+
+        line[ pos++ ] = ' ';
+        line[ pos++ ] = '<';
+        line[ pos++ ] = '2';
+        line[ pos++ ] = '^';
+        line[ pos++ ] = '0' + bucket / 10;
+        line[ pos++ ] = '0' + bucket % 10;
+        line[ pos++ ] = ' ';
+        line[ pos++ ] = ':';
+        line[ pos++ ] = ' ';
+
+        count = histogram[ bucket ];
+        nDigits = 1;
+        while ( count >= 10 )
+        {
+            count /= 10;
+            nDigits++;
+        }
+
+        count = histogram[ bucket ];
+        line[ pos + nDigits ] = 0;
+        while ( nDigits != 0 )
+        {
+            nDigits--;
+            line[ pos + nDigits ] = '0' + count % 10;
+            count /= 10;
+        }
+
+        putsFp( line );
+    }
 }
+#endif
 
-/* SPI serial interface mode function*/
-void pressure_spiSerialInterfaceMode( uint8_t wireInterface )
+#ifdef   __PRESSURE_SCHEDULER__
+static uint8_t _schedAdd( T_pressure_taskFp taskFp, uint32_t period, uint32_t deadline )
 {
-    uint8_t temp;
+    uint8_t id;
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    if ( _schedNTasks >= _PRESSURE_SCHED_MAX_TASKS )
+    {
+        return _PRESSURE_SCHED_NO_TASK;
+    }
 
-     if ( wireInterface == 4 )
-     {
-         temp &= 0xEF;
-     }
+    id = _schedNTasks++;
 
-     if ( wireInterface == 3 )
-     {
-         temp |= 0x01;
-     }
+    _schedTaskFp[ id ] = taskFp;
+    _schedPeriod[ id ] = period;
+    _schedDeadline[ id ] = deadline;
+    _schedRelease[ id ] = _getTick() + period;
+    _schedReleased[ id ] = 0;
+    _schedStats[ id ].nRuns = 0;
+    _schedStats[ id ].nMissed = 0;
+    _schedStats[ id ].maxLateness = 0;
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, temp );
+    return id;
 }
+#endif
 
-/* Reboot memory content mode function*/
-void pressure_rebootMemoryMode( uint8_t rmMode )
+#ifdef   __PRESSURE_TRACE__
+static void _traceRecord( uint8_t *wBuffer, uint8_t nWrite, uint8_t *rBuffer, uint8_t nRead, uint8_t err )
 {
-    uint8_t temp;
-
-    rmMode %= 2;
-    rmMode <<= 7;
+    uint8_t record[ 6 + 31 ];
+    uint8_t *pData;
+    uint8_t nData;
+    uint8_t cnt;
+    uint32_t tick;
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG2 );
+    if ( _traceSink == 0 )
+    {
+        return;
+    }
 
-    temp |= rmMode;
+    if ( nRead != 0 )
+    {
+        record[ 0 ] = 0x80;
+        pData = rBuffer;
+        nData = nRead;
+    }
+    else
+    {
+        record[ 0 ] = 0x00;
+        pData = wBuffer + 1;
+        nData = nWrite - 1;
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG2, temp );
-}
+    if ( nData > 31 )
+    {
+        nData = 31;
+    }
 
-/*  Software reset function*/
-void pressure_softReset()
-{
-    uint8_t temp;
+    if ( pressureInterfaceSelect == _PRESSURE_SPI_SELECT )
+    {
+        record[ 0 ] |= 0x40;
+    }
+    if ( err != _PRESSURE_OK )
+    {
+        record[ 0 ] |= 0x20;
+    }
+    record[ 0 ] |= nData;
+    record[ 1 ] = wBuffer[ 0 ];
 
-    temp = pressure_readData( _PRESSURE_CTRL_REG2 );
+    tick = _getTick();
+    record[ 2 ] = tick;
+    record[ 3 ] = tick >> 8;
+    record[ 4 ] = tick >> 16;
+    record[ 5 ] = tick >> 24;
 
-    temp |= 0x04;
+    for ( cnt = 0; cnt < nData; cnt++ )
+    {
+        record[ 6 + cnt ] = pData[ cnt ];
+    }
 
-    pressure_writeData( _PRESSURE_CTRL_REG2, temp );
+    _traceSink( record, 6 + nData );
 }
 
-/* Set interrupt configuration function*/
-void pressure_setInterruptConfig( uint8_t intConfigVal )
+#ifndef  __PRESSURE_HAL_REPLAY__
+static void _traceInt( uint8_t level )
 {
-    uint8_t temp;
+    uint8_t record[ 6 ];
+    uint32_t tick;
 
-    temp = pressure_readData( _PRESSURE_INT_CFG_REG );
+    if ( _traceSink == 0 )
+    {
+        return;
+    }
+
+    tick = _getTick();
 
-    temp |= intConfigVal;
+    record[ 0 ] = 0x1F;
+    record[ 1 ] = level;
+    record[ 2 ] = tick;
+    record[ 3 ] = tick >> 8;
+    record[ 4 ] = tick >> 16;
+    record[ 5 ] = tick >> 24;
 
-    pressure_writeData( _PRESSURE_CTRL_REG2, temp );
+    _traceSink( record, 6 );
 }
+#endif
+#endif
 
-/* Get interrupt configuration function*/
-uint8_t pressure_getInterruptConfig()
+#ifdef   __PRESSURE_STATS__
+static float _sqrt( float x )
+{
+    float scale;
+    float root;
+    uint8_t cnt;
+
+    if ( x <= 0.0f )
+    {
+        return 0.0f;
+    }
+
+    scale = 1.0f;
+    while ( x > 4.0f )
+    {
+        x *= 0.25f;
+        scale *= 2.0f;
+    }
+    while ( x < 1.0f )
+    {
+        x *= 4.0f;
+        scale *= 0.5f;
+    }
+
+    root = ( x + 1.0f ) * 0.5f;
+    for ( cnt = 0; cnt < 4; cnt++ )
+    {
+        root = ( root + x / root ) * 0.5f;
+    }
+
+    return root * scale;
+}
+
+/*
+ * 64-bit arithmetic on two 32-bit words, modulo 2^64. Intermediate results may wrap,
+ * the final sums are exact as long as the true value fits.
+ */
+static void _wideMul( uint32_t a, uint32_t b, uint32_t *hi, uint32_t *lo )
+{
+    uint32_t a1;
+    uint32_t a0;
+    uint32_t b1;
+    uint32_t b0;
+    uint32_t cross;
+
+    a1 = a >> 16;
+    a0 = a & 0xFFFF;
+    b1 = b >> 16;
+    b0 = b & 0xFFFF;
+
+    *lo = a0 * b0;
+    *hi = a1 * b1;
+
+    cross = a1 * b0;
+    _wideAdd( hi, lo, cross >> 16, cross << 16 );
+    cross = a0 * b1;
+    _wideAdd( hi, lo, cross >> 16, cross << 16 );
+}
+
+static void _wideMulSigned( int32_t a, uint32_t xHi, uint32_t xLo, uint32_t *hi, uint32_t *lo )
+{
+    _wideMul( ( uint32_t ) a, xLo, hi, lo );
+    *hi += ( uint32_t ) a * xHi;
+
+    if ( a < 0 )
+    {
+        *hi -= xLo;
+    }
+}
+
+static void _wideAdd( uint32_t *hi, uint32_t *lo, uint32_t addHi, uint32_t addLo )
+{
+    *lo += addLo;
+    *hi += addHi + ( *lo < addLo );
+}
+
+static void _wideSub( uint32_t *hi, uint32_t *lo, uint32_t subHi, uint32_t subLo )
+{
+    *hi -= subHi + ( *lo < subLo );
+    *lo -= subLo;
+}
+
+static float _wideFloat( uint32_t hi, uint32_t lo )
+{
+    if ( hi & 0x80000000 )
+    {
+        hi = ~hi + ( lo == 0 );
+        lo = ~lo + 1;
+
+        return -( ( float ) hi * 4294967296.0f + ( float ) lo );
+    }
+
+    return ( float ) hi * 4294967296.0f + ( float ) lo;
+}
+
+static void _statsResult( T_pressure_stats *stats, T_pressure_statsResult *result, float scale, float offset )
+{
+    float count;
+    float sum;
+    float variance;
+    int32_t shift;
+    int32_t residual;
+    uint32_t hi;
+    uint32_t lo;
+    uint32_t sqHi;
+    uint32_t sqLo;
+
+    result->count = stats->count;
+    result->min = ( float ) stats->min * scale + offset;
+    result->max = ( float ) stats->max * scale + offset;
+    result->mean = offset;
+    result->stdDev = 0.0f;
+
+    if ( stats->count == 0 )
+    {
+        return;
+    }
+
+    count = ( float ) stats->count;
+    sum = _wideFloat( stats->sumHi, stats->sumLo );
+
+    result->mean = ( ( float ) stats->ref + sum / count ) * scale + offset;
+
+    if ( stats->count > 1 )
+    {
+        //  deviations from an integer close to the mean, d - shift, keep the sums small :
+        //  residual = sum - n shift, sum ( d - shift )^2 = sumSq - shift ( sum + residual )
+        shift = ( int32_t ) ( sum / count + ( sum < 0.0f ? -0.5f : 0.5f ) );
+
+        hi = stats->sumHi;
+        lo = stats->sumLo;
+        _wideMulSigned( shift, 0, stats->count, &sqHi, &sqLo );
+        _wideSub( &hi, &lo, sqHi, sqLo );
+        residual = ( int32_t ) lo;
+
+        _wideAdd( &hi, &lo, stats->sumHi, stats->sumLo );
+        _wideMulSigned( shift, hi, lo, &hi, &lo );
+        sqHi = stats->sumSqHi;
+        sqLo = stats->sumSqLo;
+        _wideSub( &sqHi, &sqLo, hi, lo );
+
+        variance = ( _wideFloat( sqHi, sqLo ) - ( float ) residual * ( float ) residual / count ) / ( count - 1.0f );
+        result->stdDev = _sqrt( variance ) * scale;
+    }
+}
+#endif
+
+#ifdef   __PRESSURE_DECIMATOR__
+static void _decimatorRestart( T_pressure_decimator *dec, int32_t reference )
+{
+    dec->reference = reference;
+    dec->integrator1 = 0;
+    dec->integrator2 = 0;
+    dec->comb1 = 0;
+    dec->comb2 = 0;
+    dec->fir[ 0 ] = 0;
+    dec->fir[ 1 ] = 0;
+
+    //  two CIC output periods and two FIR taps, one more when the first block is partial
+    dec->settle = dec->phase != 0 ? 4 : 3;
+}
+#endif
+
+#ifdef   __PRESSURE_CALIBRATION__
+static uint32_t _calCorrect( uint32_t rawPressure, int16_t rawTemperature )
+{
+    int32_t corrected;
+
+    corrected = ( int32_t ) ( rawPressure & 0x00FFFFFF ) + _calibration.offset;
+    corrected += ( ( int32_t ) _calibration.tempco * ( ( int32_t ) rawTemperature - _calibration.tempRef ) ) / 256;
+
+    if ( corrected < 0 )
+    {
+        return 0;
+    }
+    if ( corrected > 0x00FFFFFF )
+    {
+        return 0x00FFFFFF;
+    }
+
+    return ( uint32_t ) corrected;
+}
+
+static uint32_t _calApply( uint32_t rawPressure, int16_t rawTemperature )
+{
+    uint32_t corrected;
+
+    corrected = _calCorrect( rawPressure, rawTemperature );
+    corrected = ( corrected >> 14 ) * _calibration.gain + ( ( ( corrected & 0x3FFF ) * _calibration.gain + 0x2000 ) >> 14 );
+
+    if ( corrected > 0x00FFFFFF )
+    {
+        return 0x00FFFFFF;
+    }
+
+    return corrected;
+}
+#endif
+
+static uint8_t _probeOne( T_pressure_probeEntry *entry )
+{
+    uint8_t id;
+
+    pressureInterfaceSelect = entry->interfaceSelect;
+#ifdef   __PRESSURE_DRV_I2C__
+    _slaveAddress = entry->slaveAddress;
+#endif
+
+    if ( _regRead( _PRESSURE_DEVICE_ID_REG, &id, 1 ) != _PRESSURE_OK )
+    {
+        return 0;
+    }
+
+    return id == 0xBB;
+}
+
+static uint8_t _warmWrite( uint8_t regAddress, uint8_t current, uint8_t desired )
+{
+    uint8_t err;
+#ifdef   __PRESSURE_VERIFY_WRITES__
+    uint8_t readBack;
+#endif
+
+    if ( current == desired )
+    {
+        return _PRESSURE_OK;
+    }
+
+    err = _regWrite( regAddress, desired );
+
+#ifdef   __PRESSURE_VERIFY_WRITES__
+    if ( err == _PRESSURE_OK )
+    {
+        err = _regRead( regAddress, &readBack, 1 );
+    }
+    if ( err == _PRESSURE_OK && readBack != desired )
+    {
+        err = _PRESSURE_ERR_VERIFY;
+    }
+#endif
+
+    return err;
+}
+
+static uint8_t _setField( uint8_t field, uint8_t value )
 {
     uint8_t temp;
+    uint8_t mask;
+    uint8_t err;
 
-    temp = pressure_readData( _PRESSURE_INT_CFG_REG );
+    if ( field >= sizeof( _PRESSURE_FIELDS ) / sizeof( _PRESSURE_FIELDS[ 0 ] ) )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
 
-    return temp;
+    mask = ( 1 << _PRESSURE_FIELDS[ field ].width ) - 1;
+
+    if ( value & ~mask )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    err = _regRead( _PRESSURE_FIELDS[ field ].regAddress, &temp, 1 );
+
+    if ( err != _PRESSURE_OK )
+    {
+        return err;
+    }
+
+    mask <<= _PRESSURE_FIELDS[ field ].shift;
+    temp &= ~mask;
+    temp |= value << _PRESSURE_FIELDS[ field ].shift;
+
+    return _regWrite( _PRESSURE_FIELDS[ field ].regAddress, temp );
 }
 
-/* Default configuration function */
-uint8_t pressure_defaultCofig()
+static uint8_t _setConfiguration( uint8_t configVal )
 {
     uint8_t temp;
     uint8_t err;
 
-    err = 1;
+    err = _regRead( _PRESSURE_RES_CONFIG, &temp, 1 );
 
-    pressure_writeData( _PRESSURE_RES_CONFIG, 0x78 );
-    temp = pressure_readData( _PRESSURE_RES_CONFIG );
+    if ( err != _PRESSURE_OK )
+    {
+        return err;
+    }
 
-    if ( temp != 0x78 )
+    temp |= configVal;
+    _profileApplied = 0xFF;
+
+    return _regWrite( _PRESSURE_RES_CONFIG, temp );
+}
+
+static uint8_t _warmStart( T_pressure_config *cfg )
+{
+    uint8_t idRes[ 2 ];
+    uint8_t ctrl[ 7 ];
+    uint8_t changed;
+    uint8_t err;
+
+    _profileApplied = 0xFF;
+
+    err = _regRead( _PRESSURE_DEVICE_ID_REG, idRes, 2 );
+    if ( err != _PRESSURE_OK )
     {
-        err = 0;
+        return err;
     }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, 0x74 );
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    if ( idRes[ 0 ] != 0xBB )
+    {
+        return _PRESSURE_ERR_VERIFY;
+    }
 
-    if ( temp != 0x74 )
+    err = _regRead( _PRESSURE_CTRL_REG1, ctrl, 7 );
+    if ( err != _PRESSURE_OK )
     {
-        err = 0;
+        return err;
     }
 
-    pressure_writeData( _PRESSURE_CTRL_REG1, 0xF4 );
-    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+    //  ctrl[] : CTRL_REG1, CTRL_REG2, CTRL_REG3, INT_CFG, INT_SOURCE, THS_P_L, THS_P_H
+    changed = cfg->ctrlReg1 != ctrl[ 0 ];
+    changed |= cfg->resConfig != idRes[ 1 ];
+    changed |= cfg->ctrlReg2 != ctrl[ 1 ];
+    changed |= cfg->ctrlReg3 != ctrl[ 2 ];
+    changed |= cfg->intConfig != ctrl[ 3 ];
+    changed |= cfg->thsPLsb != ctrl[ 5 ];
+    changed |= cfg->thsPMsb != ctrl[ 6 ];
+
+    //  any change is written powered down, CTRL_REG1 restored last
+    if ( changed && ( ctrl[ 0 ] & 0x80 ) )
+    {
+        err = _warmWrite( _PRESSURE_CTRL_REG1, ctrl[ 0 ], ctrl[ 0 ] & 0x7F );
+        ctrl[ 0 ] &= 0x7F;
+    }
+    if ( err == _PRESSURE_OK )
+    {
+        err = _warmWrite( _PRESSURE_RES_CONFIG, idRes[ 1 ], cfg->resConfig );
+    }
+    if ( err == _PRESSURE_OK )
+    {
+        err = _warmWrite( _PRESSURE_CTRL_REG2, ctrl[ 1 ], cfg->ctrlReg2 );
+    }
+    if ( err == _PRESSURE_OK )
+    {
+        err = _warmWrite( _PRESSURE_CTRL_REG3, ctrl[ 2 ], cfg->ctrlReg3 );
+    }
+    if ( err == _PRESSURE_OK )
+    {
+        err = _warmWrite( _PRESSURE_INT_CFG_REG, ctrl[ 3 ], cfg->intConfig );
+    }
+    if ( err == _PRESSURE_OK )
+    {
+        err = _warmWrite( _PRESSURE_THS_P_LSB_REG, ctrl[ 5 ], cfg->thsPLsb );
+    }
+    if ( err == _PRESSURE_OK )
+    {
+        err = _warmWrite( _PRESSURE_THS_P_MSB_REG, ctrl[ 6 ], cfg->thsPMsb );
+    }
+    if ( err == _PRESSURE_OK )
+    {
+        err = _warmWrite( _PRESSURE_CTRL_REG1, ctrl[ 0 ], cfg->ctrlReg1 );
+    }
 
-    if ( temp != 0xF4 )
+    return err;
+}
+
+static uint8_t _setPowerProfile( uint8_t profile )
+{
+    uint8_t ctrlReg1;
+    uint8_t err;
+    uint8_t frontEnd;
+
+    if ( profile > _PRESSURE_PROFILE_HIGH_RATE )
     {
-        err = 0;
+        return _PRESSURE_ERR_PARAM;
     }
 
-    temp = pressure_readData( _PRESSURE_DEVICE_ID_REG );
+    err = _regRead( _PRESSURE_CTRL_REG1, &ctrlReg1, 1 );
 
-    if ( temp != 0xBB )
+    if ( err != _PRESSURE_OK )
     {
-        err = 0;
+        return err;
+    }
+
+    frontEnd = 1;
+    if ( _profileApplied < 4 )
+    {
+        if ( _PRESSURE_PROFILES[ _profileApplied ].resConfig == _PRESSURE_PROFILES[ profile ].resConfig &&
+             _PRESSURE_PROFILES[ _profileApplied ].ampCtrl == _PRESSURE_PROFILES[ profile ].ampCtrl )
+        {
+            frontEnd = 0;
+        }
+    }
+
+    _profileApplied = 0xFF;
+    ctrlReg1 &= 0x0F;
+
+    if ( frontEnd )
+    {
+        err = _regWrite( _PRESSURE_CTRL_REG1, ctrlReg1 );
+        if ( err == _PRESSURE_OK )
+        {
+            err = _regWrite( _PRESSURE_RES_CONFIG, _PRESSURE_PROFILES[ profile ].resConfig );
+        }
+        if ( err == _PRESSURE_OK )
+        {
+            err = _regWrite( _PRESSURE_AMP_CTRL, _PRESSURE_PROFILES[ profile ].ampCtrl );
+        }
+        if ( err != _PRESSURE_OK )
+        {
+            return err;
+        }
+    }
+
+    ctrlReg1 |= 0x80;
+    ctrlReg1 |= _PRESSURE_PROFILES[ profile ].outDataRate << 4;
+
+    err = _regWrite( _PRESSURE_CTRL_REG1, ctrlReg1 );
+
+    if ( err == _PRESSURE_OK )
+    {
+        _profileApplied = profile;
     }
 
     return err;
 }
 
-/* Get pressure function */
-float pressure_getPressure()
+#ifdef   __PRESSURE_TXN_QUEUE__
+static uint8_t _queueComplete( uint8_t entry, uint8_t err, uint32_t now )
 {
-    uint32_t presVal;
-    float pressure;
-    uint8_t buffer[ 3 ];
+    uint8_t slot;
+    uint8_t cnt;
+    uint8_t nServed;
+    uint8_t offset;
 
-    buffer[ 0 ] = pressure_readData( _PRESSURE_PRESS_OUT_MSB );
-    buffer[ 1 ] =  pressure_readData( _PRESSURE_PRESS_OUT_LSB );
-    buffer[ 2 ] = pressure_readData( _PRESSURE_PRESS_POUT_XLB_REH );
+    nServed = 0;
 
-    presVal = buffer[ 0 ];
-    presVal <<= 8;
-    presVal |= buffer[ 1 ];
-    presVal <<= 8;
-    presVal |= buffer[ 2 ];
+    for ( slot = 0; slot < _PRESSURE_QUEUE_SIZE; slot++ )
+    {
+        if ( _queue[ slot ].pending == 0 )
+        {
+            continue;
+        }
+
+        if ( _queue[ slot ].regAddress < _cacheReg[ entry ] ||
+             _queue[ slot ].regAddress + _queue[ slot ].nBytes > _cacheReg[ entry ] + _cacheLen[ entry ] )
+        {
+            continue;
+        }
+
+        offset = _queue[ slot ].regAddress - _cacheReg[ entry ];
+
+        for ( cnt = 0; cnt < _queue[ slot ].nBytes; cnt++ )
+        {
+            _queue[ slot ].rBuffer[ cnt ] = _cacheData[ entry ][ offset + cnt ];
+        }
+
+        if ( ( int32_t )( now - _queue[ slot ].deadline ) > 0 )
+        {
+            _queueStats.late++;
+        }
+
+        _queue[ slot ].pending = 0;
+        _queue[ slot ].err = err;
+        _queue[ slot ].notify = ( _queue[ slot ].doneFp != 0 );
+        nServed++;
+    }
 
-    presVal &= 0x00FFFFFF;
+    return nServed;
+}
 
-    pressure = ( float ) presVal;
-    pressure /= 4096.0;
+#endif
+#ifdef   __PRESSURE_DRV_UART__
+static uint8_t _crc8( uint8_t crc, uint8_t *buffer, uint8_t nBytes )
+{
+    uint8_t nBits;
 
-    return pressure;
+    while ( nBytes != 0 )
+    {
+        crc ^= *buffer++;
+        nBytes--;
+
+        for ( nBits = 0; nBits < 8; nBits++ )
+        {
+            if ( crc & 0x80 )
+            {
+                crc = ( crc << 1 ) ^ 0x07;
+            }
+            else
+            {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
 }
 
-/* Get temperature in degrees Celsius function */
-float pressure_getTemperature()
+static uint8_t _streamFrame( uint8_t frameType, uint8_t *payload, uint8_t nPayload )
 {
-    uint8_t buffer[ 2 ];
-    int16_t tempVal;
-    float temperature;
+    uint8_t header[ 3 ];
+    uint8_t crc;
+    uint8_t head;
+    uint8_t cnt;
 
-    buffer[ 0 ] = pressure_readData( _PRESSURE_TEMP_OUT_MSB );
-    buffer[ 1 ] = pressure_readData( _PRESSURE_TEMP_OUT_LSB );
+    //  free space, one slot stays empty to tell full from empty
+    if ( ( uint8_t )( _txTail - _txHead - 1 ) % _PRESSURE_STREAM_RING_SIZE < nPayload + 5 )
+    {
+        //  dropped frame still takes its sequence number, the host sees the gap
+        _txSequence++;
+        _streamStats.overflows++;
 
-    tempVal = buffer[ 0 ];
-    tempVal <<= 8;
-    tempVal |= buffer[ 1 ];
+        return 0;
+    }
 
-    temperature = ( float ) tempVal;
-    temperature /= 480.0;
-    temperature += 42.5;
+    header[ 0 ] = frameType;
+    header[ 1 ] = _txSequence++;
+    header[ 2 ] = nPayload;
 
-    return temperature;
+    crc = _crc8( 0, header, 3 );
+    crc = _crc8( crc, payload, nPayload );
+
+    head = _txHead;
+
+    _txRing[ head ] = _PRESSURE_FRAME_SYNC;
+    head = ( head + 1 ) % _PRESSURE_STREAM_RING_SIZE;
+
+    for ( cnt = 0; cnt < 3; cnt++ )
+    {
+        _txRing[ head ] = header[ cnt ];
+        head = ( head + 1 ) % _PRESSURE_STREAM_RING_SIZE;
+    }
+
+    for ( cnt = 0; cnt < nPayload; cnt++ )
+    {
+        _txRing[ head ] = payload[ cnt ];
+        head = ( head + 1 ) % _PRESSURE_STREAM_RING_SIZE;
+    }
+
+    _txRing[ head ] = crc;
+    head = ( head + 1 ) % _PRESSURE_STREAM_RING_SIZE;
+
+    //  publish the whole frame at once for the TX interrupt
+    _txHead = head;
+
+    return 1;
 }
 
-/* Get interrupt state function*/
-uint8_t pressure_getInterruptState()
+static void _streamCommand()
 {
-    return hal_gpio_intGet();
+    uint8_t ack[ 2 ];
+
+    ack[ 0 ] = _rxFrame[ 1 ];
+    ack[ 1 ] = _PRESSURE_ERR_PARAM;
+
+    if ( _rxFrame[ 3 ] == 1 && _rxFrame[ 1 ] == _PRESSURE_CMD_SET_ODR && _rxFrame[ 4 ] < 8 )
+    {
+        ack[ 1 ] = pressure_setOutputDataRate( _rxFrame[ 4 ] );
+    }
+    if ( _rxFrame[ 3 ] == 1 && _rxFrame[ 1 ] == _PRESSURE_CMD_SET_PROFILE )
+    {
+        ack[ 1 ] = pressure_setPowerProfile( _rxFrame[ 4 ] );
+    }
+
+    if ( ack[ 1 ] == _PRESSURE_OK )
+    {
+        _streamStats.commands++;
+    }
+
+    _streamFrame( _PRESSURE_FRAME_ACK, ack, 2 );
 }
 
+#endif
+#ifdef   __PRESSURE_IDLE__
+static void _idleTouch()
+{
+    uint32_t start;
+    uint32_t latency;
+    uint16_t nPolls;
+    uint16_t maxPolls;
+    uint8_t image[ 5 ];
+    uint8_t status;
+    uint8_t dataMask;
+    uint8_t odr;
+
+    start = _getTick();
+    _idleLastRead = start;
+
+    if ( _idleAsleep == 0 )
+    {
+        return;
+    }
+
+    if ( pressure_enable() != _PRESSURE_OK )
+    {
+        return;
+    }
+
+    _idleAsleep = 0;
+    _idleStats.sleepTicks += start - _idleSince;
+
+    //  drop data available flags left from before the power-down
+    pressure_readBytes( _PRESSURE_PRESS_POUT_XLB_REH, image, 5 );
+
+    if ( pressure_getField( _PRESSURE_FIELD_ODR, &odr ) != _PRESSURE_OK )
+    {
+        odr = 1;
+    }
+
+    if ( odr == 0 )
+    {
+        pressure_setField( _PRESSURE_FIELD_ONE_SHOT, 1 );
+    }
+
+    //  one pressure output period + 10 %, one shot and 1 Hz bounded by 1.1 s
+    switch ( odr )
+    {
+        case 2 :
+        case 5 :
+            maxPolls = 158;
+            break;
+        case 3 :
+        case 6 :
+            maxPolls = 88;
+            break;
+        case 4 :
+        case 7 :
+            maxPolls = 44;
+            break;
+        default :
+            maxPolls = 1100;
+            break;
+    }
+
+    //  temperature runs at 1 Hz with ODR 2 to 4, wait for P_DA only
+    dataMask = ( odr >= 2 && odr <= 4 ) ? 0x02 : 0x03;
+
+    for ( nPolls = 0; nPolls < maxPolls; nPolls++ )
+    {
+        if ( pressure_readRegister( _PRESSURE_STATUS_REG, &status ) != _PRESSURE_OK )
+        {
+            break;
+        }
 
+        if ( ( status & dataMask ) == dataMask )
+        {
+            break;
+        }
+
+        Delay_1ms();
+    }
+
+    _idleLastRead = _getTick();
+    _idleSince = _idleLastRead;
+
+    latency = _idleLastRead - start;
+    _idleStats.wakes++;
+    _idleStats.wakeTicks += latency;
+
+    if ( latency > _idleStats.maxWakeTicks )
+    {
+        _idleStats.maxWakeTicks = latency;
+    }
+}
+
+#endif
+#ifdef   __PRESSURE_RESAMPLER__
+static int32_t _mulFrac( int32_t value, uint16_t fraction )
+{
+    uint32_t magnitude;
+    uint32_t result;
+
+    //  value * fraction / 2^16, rounded, without 64-bit product
+    magnitude = ( value < 0 ) ? ( uint32_t )( -value ) : ( uint32_t ) value;
+    result = ( magnitude >> 16 ) * fraction + ( ( ( magnitude & 0xFFFF ) * fraction + 0x8000 ) >> 16 );
+
+    return ( value < 0 ) ? -( int32_t ) result : ( int32_t ) result;
+}
+
+#endif
+#ifdef   __PRESSURE_RATE__
+static uint32_t _mulQ24( uint32_t a, uint32_t k )
+{
+    uint32_t a1;
+    uint32_t a0;
+    uint32_t k1;
+    uint32_t k0;
+    uint32_t high;
+
+    //  a * k / 2^24 from 15-bit halves, a and k below 2^30
+    a1 = a >> 15;
+    a0 = a & 0x7FFF;
+    k1 = k >> 15;
+    k0 = k & 0x7FFF;
+
+    high = a1 * k1;
+
+    if ( high >= 0x02000000 )
+    {
+        return 0x7FFFFFFF;
+    }
+
+    return ( high << 6 ) + ( ( a1 * k0 + a0 * k1 ) >> 9 ) + ( ( a0 * k0 ) >> 24 );
+}
+
+#endif
+#ifdef   __PRESSURE_MEDIAN__
+#define _MEDIAN_CENTRE          ( _PRESSURE_MEDIAN_WINDOW / 2 )
+
+/*
+ * Heap indices count from the array base. The median sits at _MEDIAN_CENTRE, the min heap
+ * node k at _MEDIAN_CENTRE + k and the max heap node k at _MEDIAN_CENTRE - k, k = 1, 2 ..
+ * Children of node k are 2k and 2k + 1, the median is the parent of both node 1.
+ */
+static uint8_t _medianLess( T_pressure_median *mf, uint8_t i, uint8_t j )
+{
+    return mf->data[ mf->heap[ i ] ] < mf->data[ mf->heap[ j ] ];
+}
+
+static uint8_t _medianSwap( T_pressure_median *mf, uint8_t i, uint8_t j )
+{
+    uint8_t slot;
+
+    slot = mf->heap[ i ];
+    mf->heap[ i ] = mf->heap[ j ];
+    mf->heap[ j ] = slot;
+
+    mf->pos[ mf->heap[ i ] ] = i;
+    mf->pos[ mf->heap[ j ] ] = j;
+
+    return 1;
+}
+
+static void _medianMinDown( T_pressure_median *mf, uint8_t k )
+{
+    uint8_t minCount;
+
+    //  count never exceeds the window, the bound keeps every index inside the array
+    minCount = ( mf->count - 1 ) / 2;
+    minCount = ( minCount > _MEDIAN_CENTRE ) ? _MEDIAN_CENTRE : minCount;
+
+    for ( ; k <= minCount; k *= 2 )
+    {
+        if ( k > 1 && k < minCount && _medianLess( mf, _MEDIAN_CENTRE + k + 1, _MEDIAN_CENTRE + k ) )
+        {
+            k++;
+        }
+
+        if ( !_medianLess( mf, _MEDIAN_CENTRE + k, _MEDIAN_CENTRE + k / 2 ) )
+        {
+            break;
+        }
+
+        _medianSwap( mf, _MEDIAN_CENTRE + k, _MEDIAN_CENTRE + k / 2 );
+    }
+}
+
+static void _medianMaxDown( T_pressure_median *mf, uint8_t k )
+{
+    uint8_t maxCount;
+
+    maxCount = mf->count / 2;
+    maxCount = ( maxCount > _MEDIAN_CENTRE ) ? _MEDIAN_CENTRE : maxCount;
+
+    for ( ; k <= maxCount; k *= 2 )
+    {
+        if ( k > 1 && k < maxCount && _medianLess( mf, _MEDIAN_CENTRE - k, _MEDIAN_CENTRE - k - 1 ) )
+        {
+            k++;
+        }
+
+        if ( !_medianLess( mf, _MEDIAN_CENTRE - k / 2, _MEDIAN_CENTRE - k ) )
+        {
+            break;
+        }
+
+        _medianSwap( mf, _MEDIAN_CENTRE - k / 2, _MEDIAN_CENTRE - k );
+    }
+}
+
+static uint8_t _medianMinUp( T_pressure_median *mf, uint8_t k )
+{
+    while ( k > 0 && _medianLess( mf, _MEDIAN_CENTRE + k, _MEDIAN_CENTRE + k / 2 ) )
+    {
+        _medianSwap( mf, _MEDIAN_CENTRE + k, _MEDIAN_CENTRE + k / 2 );
+        k /= 2;
+    }
+
+    return k == 0;
+}
+
+static uint8_t _medianMaxUp( T_pressure_median *mf, uint8_t k )
+{
+    while ( k > 0 && _medianLess( mf, _MEDIAN_CENTRE - k / 2, _MEDIAN_CENTRE - k ) )
+    {
+        _medianSwap( mf, _MEDIAN_CENTRE - k / 2, _MEDIAN_CENTRE - k );
+        k /= 2;
+    }
+
+    return k == 0;
+}
+
+#endif
+#ifdef   _PRESSURE_BLOCK_LANES
+/*
+ * Every group of 4 samples is 20 bytes, loaded as bytes 0..15 ( a ) and 4..19 ( b ).
+ * Byte shuffles place the 24-bit pressure in the low bytes of each 32-bit lane and the
+ * 16-bit temperature in the high bytes, arithmetic shift then sign extends it.
+ */
+
+static size_t _blockPressure( const uint8_t *raw, size_t nSamples, float *outP )
+{
+    size_t cnt;
+#if defined( __AVX2__ )
+    __m256i maskA;
+    __m256i maskB;
+    __m256i a;
+    __m256i b;
+    __m256 scale;
+
+    maskA = _mm256_broadcastsi128_si256( _mm_setr_epi8( 0, 1, 2, -1, 5, 6, 7, -1, 10, 11, 12, -1, -1, -1, -1, -1 ) );
+    maskB = _mm256_broadcastsi128_si256( _mm_setr_epi8( -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, -1 ) );
+    scale = _mm256_set1_ps( 0.000244140625f );
+
+    for ( cnt = 0; cnt + 8 <= nSamples; cnt += 8 )
+    {
+        a = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( ( const __m128i* )( raw ) ) ),
+                                     _mm_loadu_si128( ( const __m128i* )( raw + 20 ) ), 1 );
+        b = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( ( const __m128i* )( raw + 4 ) ) ),
+                                     _mm_loadu_si128( ( const __m128i* )( raw + 24 ) ), 1 );
+
+        a = _mm256_or_si256( _mm256_shuffle_epi8( a, maskA ), _mm256_shuffle_epi8( b, maskB ) );
+        _mm256_storeu_ps( outP + cnt, _mm256_mul_ps( _mm256_cvtepi32_ps( a ), scale ) );
+
+        raw += 40;
+    }
+#elif defined( __SSSE3__ )
+    __m128i maskA;
+    __m128i maskB;
+    __m128i a;
+    __m128i b;
+    __m128 scale;
+
+    maskA = _mm_setr_epi8( 0, 1, 2, -1, 5, 6, 7, -1, 10, 11, 12, -1, -1, -1, -1, -1 );
+    maskB = _mm_setr_epi8( -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, -1 );
+    scale = _mm_set1_ps( 0.000244140625f );
+
+    for ( cnt = 0; cnt + 4 <= nSamples; cnt += 4 )
+    {
+        a = _mm_loadu_si128( ( const __m128i* )( raw ) );
+        b = _mm_loadu_si128( ( const __m128i* )( raw + 4 ) );
+
+        a = _mm_or_si128( _mm_shuffle_epi8( a, maskA ), _mm_shuffle_epi8( b, maskB ) );
+        _mm_storeu_ps( outP + cnt, _mm_mul_ps( _mm_cvtepi32_ps( a ), scale ) );
+
+        raw += 20;
+    }
+#endif
+
+    return cnt;
+}
+
+static size_t _blockTemperature( const uint8_t *raw, size_t nSamples, float *outT )
+{
+    size_t cnt;
+#if defined( __AVX2__ )
+    __m256i maskA;
+    __m256i maskB;
+    __m256i a;
+    __m256i b;
+    __m256 scale;
+    __m256 offset;
+
+    maskA = _mm256_broadcastsi128_si256( _mm_setr_epi8( -1, -1, 3, 4, -1, -1, 8, 9, -1, -1, 13, 14, -1, -1, -1, -1 ) );
+    maskB = _mm256_broadcastsi128_si256( _mm_setr_epi8( -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, 15 ) );
+    scale = _mm256_set1_ps( 0.00208333333f );
+    offset = _mm256_set1_ps( 42.5f );
+
+    for ( cnt = 0; cnt + 8 <= nSamples; cnt += 8 )
+    {
+        a = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( ( const __m128i* )( raw ) ) ),
+                                     _mm_loadu_si128( ( const __m128i* )( raw + 20 ) ), 1 );
+        b = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( ( const __m128i* )( raw + 4 ) ) ),
+                                     _mm_loadu_si128( ( const __m128i* )( raw + 24 ) ), 1 );
+
+        a = _mm256_or_si256( _mm256_shuffle_epi8( a, maskA ), _mm256_shuffle_epi8( b, maskB ) );
+        a = _mm256_srai_epi32( a, 16 );
+        _mm256_storeu_ps( outT + cnt, _mm256_add_ps( _mm256_mul_ps( _mm256_cvtepi32_ps( a ), scale ), offset ) );
+
+        raw += 40;
+    }
+#elif defined( __SSSE3__ )
+    __m128i maskA;
+    __m128i maskB;
+    __m128i a;
+    __m128i b;
+    __m128 scale;
+    __m128 offset;
+
+    maskA = _mm_setr_epi8( -1, -1, 3, 4, -1, -1, 8, 9, -1, -1, 13, 14, -1, -1, -1, -1 );
+    maskB = _mm_setr_epi8( -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, 15 );
+    scale = _mm_set1_ps( 0.00208333333f );
+    offset = _mm_set1_ps( 42.5f );
+
+    for ( cnt = 0; cnt + 4 <= nSamples; cnt += 4 )
+    {
+        a = _mm_loadu_si128( ( const __m128i* )( raw ) );
+        b = _mm_loadu_si128( ( const __m128i* )( raw + 4 ) );
+
+        a = _mm_or_si128( _mm_shuffle_epi8( a, maskA ), _mm_shuffle_epi8( b, maskB ) );
+        a = _mm_srai_epi32( a, 16 );
+        _mm_storeu_ps( outT + cnt, _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( a ), scale ), offset ) );
+
+        raw += 20;
+    }
+#endif
+
+    return cnt;
+}
+
+#endif
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+#ifdef   __PRESSURE_DRV_SPI__
+
+void pressure_spiDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P spiObj)
+{
+    pressureInterfaceSelect = _PRESSURE_SPI_SELECT;
+    _gpioObj = gpioObj;
+    _busObj = spiObj;
+    hal_spiMap( (T_HAL_P)spiObj );
+    hal_gpioMap( (T_HAL_P)gpioObj );
+
+    hal_gpio_csSet( 0 );
+}
+
+#endif
+#ifdef   __PRESSURE_DRV_I2C__
+
+void pressure_i2cDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P i2cObj, uint8_t slave)
+{
+    _slaveAddress = slave;
+    pressureInterfaceSelect = _PRESSURE_I2C_SELECT;
+    _gpioObj = gpioObj;
+    _busObj = i2cObj;
+    hal_i2cMap( (T_HAL_P)i2cObj );
+    hal_gpioMap( (T_HAL_P)gpioObj );
+
+    // ... power ON
+    // ... configure CHIP
+}
+
+#endif
+
+/* Bus probe function */
+uint8_t pressure_probe( T_PRESSURE_P gpioObj, T_PRESSURE_P i2cObj, T_PRESSURE_P spiObj, T_pressure_probeEntry *list )
+{
+    T_pressure_busStats busStats;
+    uint8_t retryBudget;
+    uint8_t nFound;
+    uint8_t prevSelect;
+#ifdef   __PRESSURE_DRV_I2C__
+    uint8_t prevSlave;
+#endif
+
+    _arbLock();
+
+#ifdef   __PRESSURE_DRV_I2C__
+    prevSlave = _slaveAddress;
+#endif
+    prevSelect = pressureInterfaceSelect;
+    busStats = _busStats;
+    retryBudget = _retryBudget;
+    _retryBudget = 0;
+    nFound = 0;
+
+    hal_gpioMap( (T_HAL_P)gpioObj );
+
+#ifdef   __PRESSURE_DRV_I2C__
+    if ( i2cObj != 0 )
+    {
+        hal_i2cMap( (T_HAL_P)i2cObj );
+
+        list[ nFound ].interfaceSelect = _PRESSURE_I2C_SELECT;
+        list[ nFound ].slaveAddress = _PRESSURE_I2C_ADDRESS_0;
+        if ( _probeOne( &list[ nFound ] ) )
+        {
+            nFound++;
+        }
+
+        list[ nFound ].interfaceSelect = _PRESSURE_I2C_SELECT;
+        list[ nFound ].slaveAddress = _PRESSURE_I2C_ADDRESS_1;
+        if ( _probeOne( &list[ nFound ] ) )
+        {
+            nFound++;
+        }
+    }
+#endif
+#ifdef   __PRESSURE_DRV_SPI__
+    if ( spiObj != 0 )
+    {
+        hal_spiMap( (T_HAL_P)spiObj );
+        hal_gpio_csSet( 1 );
+
+        list[ nFound ].interfaceSelect = _PRESSURE_SPI_SELECT;
+        list[ nFound ].slaveAddress = 0;
+        if ( _probeOne( &list[ nFound ] ) )
+        {
+            nFound++;
+        }
+    }
+#endif
+
+    _retryBudget = retryBudget;
+    _busStats = busStats;
+    _lastError = _PRESSURE_OK;
+
+    if ( nFound != 0 )
+    {
+        pressureInterfaceSelect = list[ 0 ].interfaceSelect;
+        _gpioObj = gpioObj;
+        _busObj = pressureInterfaceSelect == _PRESSURE_SPI_SELECT ? spiObj : i2cObj;
+#ifdef   __PRESSURE_DRV_I2C__
+        _slaveAddress = list[ 0 ].slaveAddress;
+#endif
+        _arbUnlock();
+
+        return nFound;
+    }
+
+    //  nothing answered, rebind the device used before the probe
+    pressureInterfaceSelect = prevSelect;
+#ifdef   __PRESSURE_DRV_I2C__
+    _slaveAddress = prevSlave;
+#endif
+
+    if ( _busObj != 0 )
+    {
+#ifdef   __PRESSURE_DRV_SPI__
+        if ( prevSelect == _PRESSURE_SPI_SELECT )
+        {
+            pressure_spiDriverInit( _gpioObj, _busObj );
+        }
+#endif
+#ifdef   __PRESSURE_DRV_I2C__
+        if ( prevSelect == _PRESSURE_I2C_SELECT )
+        {
+            pressure_i2cDriverInit( _gpioObj, _busObj, prevSlave );
+        }
+#endif
+    }
+    _arbUnlock();
+
+    return nFound;
+}
+
+#ifdef   __PRESSURE_DRV_UART__
+
+void pressure_uartDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P uartObj)
+{
+    hal_uartMap( (T_HAL_P)uartObj );
+    hal_gpioMap( (T_HAL_P)gpioObj );
+
+    pressure_streamReset();
+}
+
+#endif
+
+
+
+/* ----------------------------------------------------------- IMPLEMENTATION */
+
+
+
+/* Generic write the byte of data function */
+uint8_t pressure_writeData( uint8_t regAddress, uint8_t writeData )
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _regWrite( regAddress, writeData );
+    _arbUnlock();
+
+    return err;
+}
+
+/* Generic read the byte of data function*/
+uint8_t pressure_readData( uint8_t regAddress )
+{
+    uint8_t rBuffer[ 1 ];
+
+    pressure_readRegister( regAddress, rBuffer );
+
+    return rBuffer[ 0 ];
+}
+
+/* Generic read the byte of data with error status function */
+uint8_t pressure_readRegister( uint8_t regAddress, uint8_t *readData )
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _regRead( regAddress, readData, 1 );
+    _arbUnlock();
+
+    return err;
+}
+
+/* Device ID read function */
+uint8_t pressure_readID()
+{
+    uint8_t temp;
+
+    temp = pressure_readData( _PRESSURE_DEVICE_ID_REG );
+
+    return temp;
+}
+
+/* Set register field function */
+uint8_t pressure_setField( uint8_t field, uint8_t value )
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _setField( field, value );
+    _arbUnlock();
+
+    return err;
+}
+
+/* Get register field function */
+uint8_t pressure_getField( uint8_t field, uint8_t *value )
+{
+    uint8_t temp;
+    uint8_t err;
+
+    if ( field >= sizeof( _PRESSURE_FIELDS ) / sizeof( _PRESSURE_FIELDS[ 0 ] ) )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    err = pressure_readRegister( _PRESSURE_FIELDS[ field ].regAddress, &temp );
+
+    temp >>= _PRESSURE_FIELDS[ field ].shift;
+    temp &= ( 1 << _PRESSURE_FIELDS[ field ].width ) - 1;
+    *value = temp;
+
+    return err;
+}
+
+/* Set configuration function*/
+uint8_t pressure_setConfiguration( uint8_t configVal )
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _setConfiguration( configVal );
+    _arbUnlock();
+
+    return err;
+}
+
+/* Get configuration function*/
+uint8_t pressure_getConfiguration()
+{
+    uint8_t temp;
+
+    temp = pressure_readData( _PRESSURE_RES_CONFIG );
+
+    return temp;
+}
+
+/* Enable the device function*/
+uint8_t pressure_enable()
+{
+    return pressure_setField( _PRESSURE_FIELD_PD, 1 );
+}
+
+/* Disable the device function*/
+uint8_t pressure_powerDown()
+{
+    return pressure_setField( _PRESSURE_FIELD_PD, 0 );
+}
+
+/* Set output data rate function*/
+uint8_t pressure_setOutputDataRate( uint8_t outDataRate )
+{
+    return pressure_setField( _PRESSURE_FIELD_ODR, outDataRate % 8 );
+}
+
+/* Enable interrupt circuit function*/
+uint8_t pressure_enableInterruptCircuit()
+{
+    return pressure_setField( _PRESSURE_FIELD_DIFF_EN, 1 );
+}
+
+/* Disable interrupt function*/
+uint8_t pressure_disableInterrupt()
+{
+    return pressure_setField( _PRESSURE_FIELD_DIFF_EN, 0 );
+}
+
+/* Enable block data update function*/
+uint8_t pressure_blockDataUpdate()
+{
+    return pressure_setField( _PRESSURE_FIELD_BDU, 1 );
+}
+
+/* Disable block data - continuous update function*/
+uint8_t pressure_unblockDataUpdate()
+{
+    return pressure_setField( _PRESSURE_FIELD_BDU, 0 );
+}
+
+/* Delta pressure enable function */
+uint8_t pressure_enableDeltaPressure()
+{
+    return pressure_setField( _PRESSURE_FIELD_DELTA_EN, 1 );
+}
+
+/* Delta pressure disable function*/
+uint8_t pressure_disableDeltaPressure()
+{
+    return pressure_setField( _PRESSURE_FIELD_DELTA_EN, 0 );
+}
+
+/* SPI serial interface mode function*/
+uint8_t pressure_spiSerialInterfaceMode( uint8_t wireInterface )
+{
+    if ( wireInterface == 4 )
+    {
+        return pressure_setField( _PRESSURE_FIELD_SIM, 0 );
+    }
+
+    if ( wireInterface == 3 )
+    {
+        return pressure_setField( _PRESSURE_FIELD_SIM, 1 );
+    }
+
+    return _PRESSURE_OK;
+}
+
+/* Reboot memory content mode function*/
+uint8_t pressure_rebootMemoryMode( uint8_t rmMode )
+{
+    return pressure_setField( _PRESSURE_FIELD_BOOT, rmMode % 2 );
+}
+
+/*  Software reset function*/
+uint8_t pressure_softReset()
+{
+    return pressure_setField( _PRESSURE_FIELD_SWRESET, 1 );
+}
+
+/* Set interrupt configuration function*/
+uint8_t pressure_setInterruptConfig( uint8_t intConfigVal )
+{
+    uint8_t mask;
+
+    //  LIR, PL_E and PH_E are the only writable bits, the rest is reserved
+    mask = 1 << _PRESSURE_FIELDS[ _PRESSURE_FIELD_LIR ].shift;
+    mask |= 1 << _PRESSURE_FIELDS[ _PRESSURE_FIELD_PL_E ].shift;
+    mask |= 1 << _PRESSURE_FIELDS[ _PRESSURE_FIELD_PH_E ].shift;
+
+    if ( intConfigVal & ~mask )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    return pressure_writeData( _PRESSURE_FIELDS[ _PRESSURE_FIELD_LIR ].regAddress, intConfigVal );
+}
+
+/* Get interrupt configuration function*/
+uint8_t pressure_getInterruptConfig()
+{
+    uint8_t temp;
+
+    temp = pressure_readData( _PRESSURE_INT_CFG_REG );
+
+    return temp;
+}
+
+/* Default configuration function */
+uint8_t pressure_defaultCofig()
+{
+    uint8_t temp;
+    uint8_t err;
+
+    err = 1;
+    _profileApplied = 0xFF;
+
+    pressure_writeData( _PRESSURE_RES_CONFIG, 0x78 );
+    temp = pressure_readData( _PRESSURE_RES_CONFIG );
+
+    if ( temp != 0x78 )
+    {
+        err = 0;
+    }
+
+    pressure_writeData( _PRESSURE_CTRL_REG1, 0x74 );
+    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+
+    if ( temp != 0x74 )
+    {
+        err = 0;
+    }
+
+    pressure_writeData( _PRESSURE_CTRL_REG1, 0xF4 );
+    temp = pressure_readData( _PRESSURE_CTRL_REG1 );
+
+    if ( temp != 0xF4 )
+    {
+        err = 0;
+    }
+
+    temp = pressure_readData( _PRESSURE_DEVICE_ID_REG );
+
+    if ( temp != 0xBB )
+    {
+        err = 0;
+    }
+
+    return err;
+}
+
+/* Get default configuration function */
+void pressure_getDefaultConfig( T_pressure_config *cfg )
+{
+    cfg->resConfig = 0x78;
+    cfg->ctrlReg1 = 0xF4;
+    cfg->ctrlReg2 = 0x00;
+    cfg->ctrlReg3 = 0x00;
+    cfg->intConfig = 0x00;
+    cfg->thsPLsb = 0x00;
+    cfg->thsPMsb = 0x00;
+}
+
+/* Warm start function */
+uint8_t pressure_warmStart( T_pressure_config *cfg )
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _warmStart( cfg );
+    _arbUnlock();
+
+    return err;
+}
+
+/* Get pressure function */
+float pressure_getPressure()
+{
+    uint32_t presVal;
+    float pressure;
+    uint8_t buffer[ 5 ];
+#ifdef   __PRESSURE_CALIBRATION__
+    int16_t tempVal;
+#endif
+
+#ifdef   __PRESSURE_IDLE__
+    _idleTouch();
+#endif
+#ifdef   __PRESSURE_CALIBRATION__
+    if ( _calSet )
+    {
+        pressure_readBytes( _PRESSURE_PRESS_POUT_XLB_REH, buffer, 5 );
+
+        presVal = buffer[ 2 ];
+        presVal <<= 8;
+        presVal |= buffer[ 1 ];
+        presVal <<= 8;
+        presVal |= buffer[ 0 ];
+
+        tempVal = buffer[ 4 ];
+        tempVal <<= 8;
+        tempVal |= buffer[ 3 ];
+
+        return pressure_calibratedPressure( presVal, tempVal );
+    }
+#endif
+    pressure_readBytes( _PRESSURE_PRESS_POUT_XLB_REH, buffer, 3 );
+
+    presVal = buffer[ 2 ];
+    presVal <<= 8;
+    presVal |= buffer[ 1 ];
+    presVal <<= 8;
+    presVal |= buffer[ 0 ];
+
+    presVal &= 0x00FFFFFF;
+
+    pressure = pressure_rawToPressure( presVal );
+
+    return pressure;
+}
+
+/* Get temperature in degrees Celsius function */
+float pressure_getTemperature()
+{
+    uint8_t buffer[ 2 ];
+    int16_t tempVal;
+    float temperature;
+
+#ifdef   __PRESSURE_IDLE__
+    _idleTouch();
+#endif
+    pressure_readBytes( _PRESSURE_TEMP_OUT_LSB, buffer, 2 );
+
+    tempVal = buffer[ 1 ];
+    tempVal <<= 8;
+    tempVal |= buffer[ 0 ];
+
+    temperature = pressure_rawToTemperature( tempVal );
+
+    return temperature;
+}
+
+/* Get interrupt state function*/
+uint8_t pressure_getInterruptState()
+{
+    return _intGet();
+}
+
+/* Generic burst read function */
+uint8_t pressure_readBytes( uint8_t regAddress, uint8_t *rBuffer, uint8_t nBytes )
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _regRead( regAddress, rBuffer, nBytes );
+    _arbUnlock();
+
+    return err;
+}
+
+/* Get last error function */
+uint8_t pressure_getLastError()
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _lastError;
+    _lastError = _PRESSURE_OK;
+    _arbUnlock();
+
+    return err;
+}
+
+/* Set retry budget function */
+void pressure_setRetryBudget( uint8_t nRetries )
+{
+    _retryBudget = nRetries;
+}
+
+/* Get bus statistics function */
+void pressure_getBusStats( T_pressure_busStats *stats )
+{
+    _arbLock();
+    stats->transactions = _busStats.transactions;
+    stats->errors = _busStats.errors;
+    stats->retries = _busStats.retries;
+    stats->recoveries = _busStats.recoveries;
+    stats->errorTicks = _busStats.errorTicks;
+    _arbUnlock();
+}
+
+/* Reset bus statistics function */
+void pressure_resetBusStats()
+{
+    _arbLock();
+    _busStats.transactions = 0;
+    _busStats.errors = 0;
+    _busStats.retries = 0;
+    _busStats.recoveries = 0;
+    _busStats.errorTicks = 0;
+    _arbUnlock();
+}
+
+#ifdef   __PRESSURE_BUS_RECOVERY__
+
+/* Bus recovery function */
+uint8_t pressure_busRecovery()
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _busRecover();
+    _arbUnlock();
+
+    return err;
+}
+
+#endif
+
+/* Set tick source function */
+void pressure_setTickSource( T_pressure_tickFp tickFp )
+{
+    _tickSource = tickFp;
+    pressure_resetJitterStats();
+}
+
+/* Set timestamp mode function */
+void pressure_setTimestampMode( uint8_t tsMode )
+{
+    _timestampMode = tsMode;
+    _intTimestampValid = 0;
+}
+
+/* Capture timestamp function */
+void pressure_captureTimestamp()
+{
+    _intTimestamp = _getTick();
+    _intTimestampValid = 1;
+#ifdef   __PRESSURE_LATENCY__
+    _readyTick = _intTimestamp;
+    _readyTickValid = 1;
+#endif
+}
+
+/* Read sample function */
+uint8_t pressure_readSample( T_pressure_sample *sample )
+{
+    uint8_t buffer[ 5 ];
+    uint8_t err;
+
+#ifdef   __PRESSURE_IDLE__
+    _idleTouch();
+#endif
+    err = pressure_readBytes( _PRESSURE_PRESS_POUT_XLB_REH, buffer, 5 );
+
+    if ( err != _PRESSURE_OK )
+    {
+        return err;
+    }
+
+    if ( _timestampMode == _PRESSURE_TIMESTAMP_AT_INT && _intTimestampValid )
+    {
+        sample->timestamp = _intTimestamp;
+        _intTimestampValid = 0;
+    }
+    else
+    {
+        sample->timestamp = _getTick();
+    }
+
+    sample->pressure = buffer[ 2 ];
+    sample->pressure <<= 8;
+    sample->pressure |= buffer[ 1 ];
+    sample->pressure <<= 8;
+    sample->pressure |= buffer[ 0 ];
+
+    sample->temperature = buffer[ 4 ];
+    sample->temperature <<= 8;
+    sample->temperature |= buffer[ 3 ];
+
+#ifdef   __PRESSURE_CALIBRATION__
+    if ( _calSet )
+    {
+        sample->pressure = _calApply( sample->pressure, sample->temperature );
+    }
+#endif
+
+#ifdef   __PRESSURE_LATENCY__
+    sample->readTick = _getTick();
+    sample->readyTick = sample->readTick;
+
+    if ( _readyTickValid )
+    {
+        sample->readyTick = _readyTick;
+        _readyTickValid = 0;
+    }
+
+    _latencyAdd( _latReadyToRead, sample->readTick - sample->readyTick );
+#endif
+
+    if ( _tickSource != 0 )
+    {
+        _updateJitter( sample->timestamp );
+    }
+
+    return _PRESSURE_OK;
+}
+
+/* Get jitter statistics function */
+void pressure_getJitterStats( T_pressure_jitterStats *stats )
+{
+    stats->nIntervals = _jitterCount;
+    stats->minInterval = _jitterMin;
+    stats->maxInterval = _jitterMax;
+    stats->meanInterval = _jitterMean;
+    stats->variance = 0;
+
+    if ( _jitterCount > 1 )
+    {
+        stats->variance = _jitterM2 / ( float ) ( _jitterCount - 1 );
+    }
+}
+
+/* Reset jitter statistics function */
+void pressure_resetJitterStats()
+{
+    _lastTimestampValid = 0;
+    _jitterCount = 0;
+    _jitterMin = 0;
+    _jitterMax = 0;
+    _jitterMean = 0;
+    _jitterM2 = 0;
+}
+
+#ifdef   __PRESSURE_LATENCY__
+
+/* Poll data ready function */
+uint8_t pressure_pollDataReady()
+{
+    uint8_t intState;
+    uint8_t edge;
+
+    intState = _intGet();
+    edge = 0;
+
+    if ( intState != 0 && _lastIntState == 0 )
+    {
+        _readyTick = _getTick();
+        _readyTickValid = 1;
+        edge = 1;
+    }
+
+    _lastIntState = intState;
+
+    return edge;
+}
+
+/* Sample consumed function */
+void pressure_sampleConsumed( T_pressure_sample *sample )
+{
+    uint32_t consumeTick;
+
+    consumeTick = _getTick();
+
+    _latencyAdd( _latReadToConsume, consumeTick - sample->readTick );
+    _latencyAdd( _latReadyToConsume, consumeTick - sample->readyTick );
+}
+
+/* Get latency histogram image function */
+uint8_t pressure_getLatencyImage( uint8_t *buffer )
+{
+    uint8_t cnt;
+    uint8_t pos;
+
+    pos = 0;
+
+    for ( cnt = 0; cnt < _PRESSURE_LATENCY_BUCKETS; cnt++ )
+    {
+        buffer[ pos++ ] = _latReadyToRead[ cnt ];
+        buffer[ pos++ ] = _latReadyToRead[ cnt ] >> 8;
+    }
+    for ( cnt = 0; cnt < _PRESSURE_LATENCY_BUCKETS; cnt++ )
+    {
+        buffer[ pos++ ] = _latReadToConsume[ cnt ];
+        buffer[ pos++ ] = _latReadToConsume[ cnt ] >> 8;
+    }
+    for ( cnt = 0; cnt < _PRESSURE_LATENCY_BUCKETS; cnt++ )
+    {
+        buffer[ pos++ ] = _latReadyToConsume[ cnt ];
+        buffer[ pos++ ] = _latReadyToConsume[ cnt ] >> 8;
+    }
+
+    return pos;
+}
+
+/* Print latency histogram function */
+void pressure_printLatency( T_pressure_putsFp putsFp )
+{
+    _latencyPrint( putsFp, "RDY-RD", _latReadyToRead );
+    _latencyPrint( putsFp, "RD-CON", _latReadToConsume );
+    _latencyPrint( putsFp, "RDY-CON", _latReadyToConsume );
+}
+
+/* Reset latency histogram function */
+void pressure_resetLatency()
+{
+    uint8_t cnt;
+
+    for ( cnt = 0; cnt < _PRESSURE_LATENCY_BUCKETS; cnt++ )
+    {
+        _latReadyToRead[ cnt ] = 0;
+        _latReadToConsume[ cnt ] = 0;
+        _latReadyToConsume[ cnt ] = 0;
+    }
+}
+
+#endif
+
+
+#ifdef   __PRESSURE_SCHEDULER__
+
+/* Add periodic task function */
+uint8_t pressure_schedAddTask( T_pressure_taskFp taskFp, uint32_t period, uint32_t deadline )
+{
+    if ( deadline == 0 )
+    {
+        deadline = period;
+    }
+
+    return _schedAdd( taskFp, period, deadline );
+}
+
+/* Add data ready task function */
+uint8_t pressure_schedAddDataReadyTask( T_pressure_taskFp taskFp, uint32_t deadline )
+{
+    return _schedAdd( taskFp, 0, deadline );
+}
+
+/* Set sleep hook function */
+void pressure_schedSetSleep( T_pressure_sleepFp sleepFp )
+{
+    _schedSleepFp = sleepFp;
+}
+
+/* Scheduler run function */
+void pressure_schedRun()
+{
+    uint32_t now;
+    uint32_t lateness;
+    uint32_t idle;
+    int32_t slack;
+    int32_t bestSlack;
+    int32_t toRelease;
+    uint8_t id;
+    uint8_t best;
+    uint8_t waitInt;
+
+    now = _getTick();
+    best = _PRESSURE_SCHED_NO_TASK;
+    bestSlack = 0;
+    idle = _PRESSURE_SCHED_UNTIL_INT;
+    waitInt = 0;
+
+    for ( id = 0; id < _schedNTasks; id++ )
+    {
+        if ( _schedPeriod[ id ] == 0 )
+        {
+            if ( !_schedReleased[ id ] && _intGet() )
+            {
+                _schedRelease[ id ] = now;
+                _schedReleased[ id ] = 1;
+            }
+
+            waitInt = 1;
+        }
+        else
+        {
+            toRelease = ( int32_t ) ( _schedRelease[ id ] - now );
+
+            if ( toRelease <= 0 )
+            {
+                _schedReleased[ id ] = 1;
+            }
+            else if ( ( uint32_t ) toRelease < idle )
+            {
+                idle = ( uint32_t ) toRelease;
+            }
+        }
+
+        if ( _schedReleased[ id ] )
+        {
+            slack = ( int32_t ) ( _schedRelease[ id ] + _schedDeadline[ id ] - now );
+
+            if ( best == _PRESSURE_SCHED_NO_TASK || slack < bestSlack )
+            {
+                best = id;
+                bestSlack = slack;
+            }
+        }
+    }
+
+    if ( best == _PRESSURE_SCHED_NO_TASK )
+    {
+#ifdef   __PRESSURE_IDLE__
+        pressure_idleService();
+#endif
+        if ( _schedSleepFp != 0 && idle != _PRESSURE_SCHED_UNTIL_INT )
+        {
+            _schedIdleTicks += idle;
+            _schedSleepFp( idle );
+        }
+        else if ( _schedSleepFp != 0 && waitInt )
+        {
+            //  only data ready tasks, idle time is measured after the wake
+            _schedSleepFp( _PRESSURE_SCHED_UNTIL_INT );
+            _schedIdleTicks += _getTick() - now;
+        }
+
+        return;
+    }
+
+    lateness = now - _schedRelease[ best ];
+    if ( lateness > _schedStats[ best ].maxLateness )
+    {
+        _schedStats[ best ].maxLateness = lateness;
+    }
+
+    _schedReleased[ best ] = 0;
+    _schedTaskFp[ best ]();
+    _schedStats[ best ].nRuns++;
+
+    if ( ( int32_t ) ( _schedRelease[ best ] + _schedDeadline[ best ] - _getTick() ) < 0 )
+    {
+        _schedStats[ best ].nMissed++;
+    }
+
+    if ( _schedPeriod[ best ] != 0 )
+    {
+        _schedRelease[ best ] += _schedPeriod[ best ];
+    }
+}
+
+/* Get ODR period function */
+uint32_t pressure_schedOdrPeriod( uint8_t outDataRate, uint32_t ticksPerSecond )
+{
+    switch ( outDataRate % 8 )
+    {
+        case 1 :
+            return ticksPerSecond;
+        case 2 :
+        case 5 :
+            return ticksPerSecond / 7;
+        case 3 :
+        case 6 :
+            return ticksPerSecond * 2 / 25;
+        case 4 :
+        case 7 :
+            return ticksPerSecond / 25;
+        default :
+            return 0;
+    }
+}
+
+/* Get task statistics function */
+void pressure_schedGetStats( uint8_t taskId, T_pressure_taskStats *stats )
+{
+    stats->nRuns = _schedStats[ taskId ].nRuns;
+    stats->nMissed = _schedStats[ taskId ].nMissed;
+    stats->maxLateness = _schedStats[ taskId ].maxLateness;
+}
+
+/* Get idle ticks function */
+uint32_t pressure_schedIdleTicks()
+{
+    return _schedIdleTicks;
+}
+
+#endif
+
+/* Set analog front end control function */
+uint8_t pressure_setAmpControl( uint8_t ampCtrl )
+{
+    _profileApplied = 0xFF;
+
+    return pressure_writeData( _PRESSURE_AMP_CTRL, ampCtrl );
+}
+
+/* Set power profile function */
+uint8_t pressure_setPowerProfile( uint8_t profile )
+{
+    uint8_t err;
+
+    _arbLock();
+    err = _setPowerProfile( profile );
+    _arbUnlock();
+
+    return err;
+}
+
+/* Get power profile info function */
+uint8_t pressure_getPowerProfileInfo( uint8_t profile, T_pressure_profileInfo *info )
+{
+    if ( profile > _PRESSURE_PROFILE_HIGH_RATE )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    info->outDataRate = _PRESSURE_PROFILES[ profile ].outDataRate;
+    info->resConfig = _PRESSURE_PROFILES[ profile ].resConfig;
+    info->ampCtrl = _PRESSURE_PROFILES[ profile ].ampCtrl;
+    info->supplyCurrent = _PRESSURE_PROFILES[ profile ].supplyCurrent;
+    info->noise = _PRESSURE_PROFILES[ profile ].noise;
+
+    return _PRESSURE_OK;
+}
+
+#ifdef   __PRESSURE_TRACE__
+
+/* Set trace sink function */
+void pressure_setTraceSink( T_pressure_traceFp traceFp )
+{
+    _traceSink = traceFp;
+    _traceIntLevel = 0;
+}
+
+#endif
+#ifdef   __PRESSURE_HAL_REPLAY__
+
+/* Replay init function */
+void pressure_replayInit( const uint8_t *trace, uint32_t nBytes )
+{
+    hal_replayInit( trace, nBytes );
+}
+
+/* Replay tick function */
+uint32_t pressure_replayTick()
+{
+    return hal_replayTick();
+}
+
+/* Replay done function */
+uint8_t pressure_replayDone()
+{
+    return hal_replayDone();
+}
+
+/* Replay mismatches function */
+uint32_t pressure_replayMismatches()
+{
+    return hal_replayMismatches();
+}
+
+#endif
+
+/* Raw pressure to mbar function */
+float pressure_rawToPressure( uint32_t rawPressure )
+{
+    return ( float ) rawPressure * 0.000244140625f;
+}
+
+/* Raw temperature to degrees Celsius function */
+float pressure_rawToTemperature( int16_t rawTemperature )
+{
+    return ( float ) rawTemperature * 0.00208333333f + 42.5f;
+}
+
+/* Raw pressure to Pascal function */
+uint32_t pressure_rawToPascal( uint32_t rawPressure )
+{
+    rawPressure &= 0x00FFFFFF;
+
+    return ( rawPressure * 25 + 512 ) >> 10;
+}
+
+/* Raw temperature to centi degrees Celsius function */
+int16_t pressure_rawToCentiCelsius( int16_t rawTemperature )
+{
+    uint32_t temp;
+
+    //  ( t * 5 / 24 + 4250 ), biased by 24 * 6827 to keep the dividend positive
+    temp = ( int32_t ) rawTemperature * 5 + 163848 + 12;
+
+    return ( int16_t ) ( temp / 24 ) - 2577;
+}
+
+/* Block conversion function */
+void pressure_convertBlock( const uint8_t *raw, size_t nSamples, float *outP, float *outT )
+{
+    const uint8_t *sample;
+    size_t cnt;
+    uint32_t presVal;
+    int16_t tempVal;
+
+    if ( outP != 0 )
+    {
+#ifdef   _PRESSURE_BLOCK_LANES
+        cnt = _blockPressure( raw, nSamples, outP );
+#else
+        cnt = 0;
+#endif
+        for ( sample = raw + cnt * 5; cnt < nSamples; cnt++ )
+        {
+            presVal = sample[ 2 ];
+            presVal <<= 8;
+            presVal |= sample[ 1 ];
+            presVal <<= 8;
+            presVal |= sample[ 0 ];
+
+            outP[ cnt ] = ( float ) presVal * 0.000244140625f;
+            sample += 5;
+        }
+    }
+
+    if ( outT != 0 )
+    {
+#ifdef   _PRESSURE_BLOCK_LANES
+        cnt = _blockTemperature( raw, nSamples, outT );
+#else
+        cnt = 0;
+#endif
+        for ( sample = raw + cnt * 5; cnt < nSamples; cnt++ )
+        {
+            tempVal = sample[ 4 ];
+            tempVal <<= 8;
+            tempVal |= sample[ 3 ];
+
+            outT[ cnt ] = ( float ) tempVal * 0.00208333333f + 42.5f;
+            sample += 5;
+        }
+    }
+}
+
+#ifdef   __PRESSURE_STATS__
+
+/* Statistics reset function */
+void pressure_statsReset( T_pressure_stats *stats )
+{
+    stats->count = 0;
+    stats->ref = 0;
+    stats->min = 0;
+    stats->max = 0;
+    stats->sumHi = 0;
+    stats->sumLo = 0;
+    stats->sumSqHi = 0;
+    stats->sumSqLo = 0;
+}
+
+/* Statistics update function */
+void pressure_statsUpdate( T_pressure_stats *stats, int32_t raw )
+{
+    int32_t delta;
+    uint32_t magnitude;
+    uint32_t hi;
+    uint32_t lo;
+
+    if ( stats->count == 0 )
+    {
+        stats->ref = raw;
+        stats->min = raw;
+        stats->max = raw;
+    }
+    else if ( raw < stats->min )
+    {
+        stats->min = raw;
+    }
+    else if ( raw > stats->max )
+    {
+        stats->max = raw;
+    }
+
+    stats->count++;
+
+    delta = raw - stats->ref;
+    magnitude = ( uint32_t ) ( delta < 0 ? -delta : delta );
+
+    _wideAdd( &stats->sumHi, &stats->sumLo, ( delta < 0 ) ? 0xFFFFFFFF : 0, ( uint32_t ) delta );
+
+    //  squares of deviations up to 16 bits fit one word
+    if ( magnitude <= 0xFFFF )
+    {
+        _wideAdd( &stats->sumSqHi, &stats->sumSqLo, 0, magnitude * magnitude );
+    }
+    else
+    {
+        _wideMul( magnitude, magnitude, &hi, &lo );
+        _wideAdd( &stats->sumSqHi, &stats->sumSqLo, hi, lo );
+    }
+}
+
+/* Statistics merge function */
+void pressure_statsMerge( T_pressure_stats *dst, T_pressure_stats *src )
+{
+    int32_t shift;
+    uint32_t sumHi;
+    uint32_t sumLo;
+    uint32_t hi;
+    uint32_t lo;
+
+    if ( src->count == 0 )
+    {
+        return;
+    }
+
+    if ( dst->count == 0 )
+    {
+        dst->count = src->count;
+        dst->ref = src->ref;
+        dst->min = src->min;
+        dst->max = src->max;
+        dst->sumHi = src->sumHi;
+        dst->sumLo = src->sumLo;
+        dst->sumSqHi = src->sumSqHi;
+        dst->sumSqLo = src->sumSqLo;
+        return;
+    }
+
+    //  src deviations from the dst reference are d + shift :
+    //  sum' = sum + n shift, sumSq' = sumSq + shift ( sum + sum' )
+    shift = src->ref - dst->ref;
+
+    _wideMulSigned( shift, 0, src->count, &sumHi, &sumLo );
+    _wideAdd( &sumHi, &sumLo, src->sumHi, src->sumLo );
+
+    hi = sumHi;
+    lo = sumLo;
+    _wideAdd( &hi, &lo, src->sumHi, src->sumLo );
+    _wideMulSigned( shift, hi, lo, &hi, &lo );
+    _wideAdd( &hi, &lo, src->sumSqHi, src->sumSqLo );
+
+    _wideAdd( &dst->sumHi, &dst->sumLo, sumHi, sumLo );
+    _wideAdd( &dst->sumSqHi, &dst->sumSqLo, hi, lo );
+    dst->count += src->count;
+
+    if ( src->min < dst->min )
+    {
+        dst->min = src->min;
+    }
+    if ( src->max > dst->max )
+    {
+        dst->max = src->max;
+    }
+}
+
+/* Pressure statistics readout function */
+void pressure_statsPressure( T_pressure_stats *stats, T_pressure_statsResult *result )
+{
+    _statsResult( stats, result, 0.000244140625f, 0.0f );
+}
+
+/* Temperature statistics readout function */
+void pressure_statsTemperature( T_pressure_stats *stats, T_pressure_statsResult *result )
+{
+    _statsResult( stats, result, 0.00208333333f, 42.5f );
+}
+
+#endif
+
+#ifdef   __PRESSURE_DECIMATOR__
+
+/* Decimator init function */
+uint8_t pressure_decimatorInit( T_pressure_decimator *dec, uint8_t ratio )
+{
+    if ( ratio < 2 || ratio > 64 )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    dec->ratio = ratio;
+    dec->phase = 0;
+    dec->primed = 0;
+    dec->dropped = 0;
+    dec->gain = ( uint32_t ) ratio * ratio;
+    dec->limit = 0x40000000 / dec->gain;
+    _decimatorRestart( dec, 0 );
+
+    return _PRESSURE_OK;
+}
+
+/* Decimator process function */
+uint16_t pressure_decimatorProcess( T_pressure_decimator *dec, uint32_t *input, uint16_t nInput, uint32_t *output )
+{
+    uint16_t nOutput;
+    int32_t deviation;
+    int32_t cic;
+    uint32_t stage1;
+    uint32_t stage2;
+
+    nOutput = 0;
+
+    while ( nInput != 0 )
+    {
+        deviation = ( int32_t ) ( *input & 0x00FFFFFF ) - dec->reference;
+
+        if ( !dec->primed || deviation >= dec->limit || deviation <= -dec->limit )
+        {
+            _decimatorRestart( dec, *input & 0x00FFFFFF );
+            dec->primed = 1;
+            deviation = 0;
+        }
+
+        dec->integrator1 += ( uint32_t ) deviation;
+        dec->integrator2 += dec->integrator1;
+
+        if ( ++dec->phase == dec->ratio )
+        {
+            dec->phase = 0;
+
+            stage1 = dec->integrator2 - dec->comb1;
+            dec->comb1 = dec->integrator2;
+            stage2 = stage1 - dec->comb2;
+            dec->comb2 = stage1;
+
+            cic = ( int32_t ) stage2 / ( int32_t ) dec->gain;
+
+            if ( dec->settle != 0 )
+            {
+                dec->settle--;
+                dec->dropped++;
+            }
+            else
+            {
+                *output++ = dec->reference + ( 10 * dec->fir[ 0 ] - cic - dec->fir[ 1 ] ) / 8;
+                nOutput++;
+            }
+
+            dec->fir[ 1 ] = dec->fir[ 0 ];
+            dec->fir[ 0 ] = cic;
+        }
+
+        input++;
+        nInput--;
+    }
+
+    return nOutput;
+}
+
+#endif
+
+#ifdef   __PRESSURE_CALIBRATION__
+
+/* Set calibration storage function */
+void pressure_setCalibrationStorage( T_pressure_calFp loadFp, T_pressure_calFp storeFp )
+{
+    _calLoadFp = loadFp;
+    _calStoreFp = storeFp;
+}
+
+/* Load calibration function */
+uint8_t pressure_loadCalibration()
+{
+    T_pressure_calibration cal;
+    T_pressure_calFp storeFp;
+    uint8_t err;
+
+    if ( _calLoadFp == 0 )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    if ( _calLoadFp( &cal ) != _PRESSURE_OK )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    storeFp = _calStoreFp;
+    _calStoreFp = 0;
+    err = pressure_setCalibration( &cal );
+    _calStoreFp = storeFp;
+
+    return err;
+}
+
+/* Set calibration function */
+uint8_t pressure_setCalibration( T_pressure_calibration *cal )
+{
+    if ( cal->gain == 0 || cal->gain > 0x7FFF )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    _calibration = *cal;
+    _calSet = 1;
+
+    //  Pa per 2^24 counts = 409600 * gain / 0x4000, mbar per count = gain / 2^26
+    _calFactor = ( uint32_t ) cal->gain * 25;
+    _calScale = ( float ) cal->gain * ( 1.0f / 67108864 );
+
+    if ( _calStoreFp != 0 )
+    {
+        if ( _calStoreFp( &_calibration ) != _PRESSURE_OK )
+        {
+            return _PRESSURE_ERR_PARAM;
+        }
+    }
+
+    return _PRESSURE_OK;
+}
+
+/* Get calibration function */
+void pressure_getCalibration( T_pressure_calibration *cal )
+{
+    *cal = _calibration;
+}
+
+/* Calibrated pressure in mbar function */
+float pressure_calibratedPressure( uint32_t rawPressure, int16_t rawTemperature )
+{
+    return ( float ) _calCorrect( rawPressure, rawTemperature ) * _calScale;
+}
+
+/* Calibrated pressure in Pascal function */
+uint32_t pressure_calibratedPascal( uint32_t rawPressure, int16_t rawTemperature )
+{
+    uint32_t corrected;
+
+    corrected = _calCorrect( rawPressure, rawTemperature );
+
+    return ( ( corrected >> 12 ) * _calFactor + ( ( corrected & 0x0FFF ) * _calFactor >> 12 ) + 2048 ) >> 12;
+}
+
+#endif
+
+
+#ifdef   __PRESSURE_BUS_ARBITER__
+
+/* Set bus arbiter function */
+void pressure_setArbiter( T_pressure_arbiter *arbiter )
+{
+    if ( arbiter == 0 || arbiter->lock == 0 || arbiter->unlock == 0 )
+    {
+        _arbiter.tryLock = 0;
+        _arbiter.lock = 0;
+        _arbiter.unlock = 0;
+        _arbiter.inherit = 0;
+        _arbiter.restore = 0;
+
+        return;
+    }
+
+    _arbiter.tryLock = arbiter->tryLock;
+    _arbiter.lock = arbiter->lock;
+    _arbiter.unlock = arbiter->unlock;
+    _arbiter.inherit = arbiter->inherit;
+    _arbiter.restore = arbiter->restore;
+}
+
+/* Get bus arbitration statistics function */
+void pressure_getArbStats( T_pressure_arbStats *stats )
+{
+    stats->acquisitions = _arbStats.acquisitions;
+    stats->contentions = _arbStats.contentions;
+    stats->waitTicks = _arbStats.waitTicks;
+    stats->maxWaitTicks = _arbStats.maxWaitTicks;
+}
+
+/* Reset bus arbitration statistics function */
+void pressure_resetArbStats()
+{
+    _arbStats.acquisitions = 0;
+    _arbStats.contentions = 0;
+    _arbStats.waitTicks = 0;
+    _arbStats.maxWaitTicks = 0;
+}
+
+#endif
+
+#ifdef   __PRESSURE_TXN_QUEUE__
+
+/* Set queue merge period function */
+void pressure_queueSetPeriod( uint32_t periodTicks )
+{
+    _queuePeriod = periodTicks;
+}
+
+/* Queue read function */
+uint8_t pressure_queueRead( uint8_t regAddress, uint8_t *rBuffer, uint8_t nBytes, uint32_t deadline, T_pressure_doneFp doneFp )
+{
+    uint8_t slot;
+
+    if ( nBytes == 0 || nBytes > _PRESSURE_QUEUE_MAX_BYTES )
+    {
+        return _PRESSURE_QUEUE_NO_SLOT;
+    }
+
+    _arbLock();
+
+    for ( slot = 0; slot < _PRESSURE_QUEUE_SIZE; slot++ )
+    {
+        if ( _queue[ slot ].pending == 0 && _queue[ slot ].notify == 0 )
+        {
+            _queue[ slot ].regAddress = regAddress;
+            _queue[ slot ].nBytes = nBytes;
+            _queue[ slot ].rBuffer = rBuffer;
+            _queue[ slot ].deadline = deadline;
+            _queue[ slot ].doneFp = doneFp;
+            _queue[ slot ].pending = 1;
+            _queueStats.requests++;
+
+            break;
+        }
+    }
+
+    _arbUnlock();
+
+    if ( slot == _PRESSURE_QUEUE_SIZE )
+    {
+        return _PRESSURE_QUEUE_NO_SLOT;
+    }
+
+    return slot;
+}
+
+/* Queue pending function */
+uint8_t pressure_queuePending( uint8_t slot )
+{
+    if ( slot >= _PRESSURE_QUEUE_SIZE )
+    {
+        return 0;
+    }
+
+    return _queue[ slot ].pending;
+}
+
+/* Queue service function */
+uint8_t pressure_queueService()
+{
+    uint8_t slot;
+    uint8_t first;
+    uint8_t entry;
+    uint8_t nReads;
+    uint8_t nServed;
+    uint8_t err;
+    uint8_t low;
+    uint8_t high;
+    uint8_t widened;
+    uint32_t now;
+    T_pressure_doneFp doneFp;
+
+#ifdef   __PRESSURE_IDLE__
+    _idleTouch();
+#endif
+    _arbLock();
+
+    now = _getTick();
+    nReads = 0;
+
+    for ( ;; )
+    {
+        first = _PRESSURE_QUEUE_NO_SLOT;
+
+        for ( slot = 0; slot < _PRESSURE_QUEUE_SIZE; slot++ )
+        {
+            if ( _queue[ slot ].pending == 0 )
+            {
+                continue;
+            }
+
+            if ( first == _PRESSURE_QUEUE_NO_SLOT ||
+                 ( int32_t )( _queue[ slot ].deadline - _queue[ first ].deadline ) < 0 )
+            {
+                first = slot;
+            }
+        }
+
+        if ( first == _PRESSURE_QUEUE_NO_SLOT )
+        {
+            break;
+        }
+
+        for ( entry = 0; entry < _PRESSURE_QUEUE_CACHE; entry++ )
+        {
+            if ( _cacheValid[ entry ] != 0 && now - _cacheTick[ entry ] < _queuePeriod &&
+                 _queue[ first ].regAddress >= _cacheReg[ entry ] &&
+                 _queue[ first ].regAddress + _queue[ first ].nBytes <= _cacheReg[ entry ] + _cacheLen[ entry ] )
+            {
+                break;
+            }
+        }
+
+        if ( entry < _PRESSURE_QUEUE_CACHE )
+        {
+            _queueStats.merged += _queueComplete( entry, _PRESSURE_OK, now );
+
+            continue;
+        }
+
+        //  widen the burst over pending requests which overlap or adjoin it
+        low = _queue[ first ].regAddress;
+        high = low + _queue[ first ].nBytes;
+
+        do
+        {
+            widened = 0;
+
+            for ( slot = 0; slot < _PRESSURE_QUEUE_SIZE; slot++ )
+            {
+                if ( _queue[ slot ].pending == 0 ||
+                     _queue[ slot ].regAddress > high || _queue[ slot ].regAddress + _queue[ slot ].nBytes < low )
+                {
+                    continue;
+                }
+
+                if ( _queue[ slot ].regAddress < low &&
+                     high - _queue[ slot ].regAddress <= _PRESSURE_QUEUE_MAX_BYTES )
+                {
+                    low = _queue[ slot ].regAddress;
+                    widened = 1;
+                }
+                if ( _queue[ slot ].regAddress + _queue[ slot ].nBytes > high &&
+                     _queue[ slot ].regAddress + _queue[ slot ].nBytes - low <= _PRESSURE_QUEUE_MAX_BYTES )
+                {
+                    high = _queue[ slot ].regAddress + _queue[ slot ].nBytes;
+                    widened = 1;
+                }
+            }
+        }
+        while ( widened );
+
+        entry = _cacheNext;
+        _cacheNext = ( _cacheNext + 1 ) % _PRESSURE_QUEUE_CACHE;
+
+        _cacheReg[ entry ] = low;
+        _cacheLen[ entry ] = high - low;
+        _cacheTick[ entry ] = now;
+
+        err = _regRead( _cacheReg[ entry ], _cacheData[ entry ], _cacheLen[ entry ] );
+
+        _cacheValid[ entry ] = ( err == _PRESSURE_OK );
+        nReads++;
+        _queueStats.reads++;
+
+        nServed = _queueComplete( entry, err, now );
+        _queueStats.merged += nServed - 1;
+    }
+
+    _arbUnlock();
+
+    //  completion functions may call the driver, they run without the lock
+    for ( slot = 0; slot < _PRESSURE_QUEUE_SIZE; slot++ )
+    {
+        _arbLock();
+        doneFp = _queue[ slot ].notify ? _queue[ slot ].doneFp : 0;
+        err = _queue[ slot ].err;
+        _queue[ slot ].notify = 0;
+        _arbUnlock();
+
+        if ( doneFp != 0 )
+        {
+            doneFp( slot, err );
+        }
+    }
+
+    return nReads;
+}
+
+/* Get queue statistics function */
+void pressure_queueGetStats( T_pressure_queueStats *stats )
+{
+    _arbLock();
+    stats->requests = _queueStats.requests;
+    stats->reads = _queueStats.reads;
+    stats->merged = _queueStats.merged;
+    stats->late = _queueStats.late;
+    _arbUnlock();
+}
+
+/* Reset queue statistics function */
+void pressure_queueResetStats()
+{
+    uint8_t entry;
+
+    _arbLock();
+    _queueStats.requests = 0;
+    _queueStats.reads = 0;
+    _queueStats.merged = 0;
+    _queueStats.late = 0;
+
+    for ( entry = 0; entry < _PRESSURE_QUEUE_CACHE; entry++ )
+    {
+        _cacheValid[ entry ] = 0;
+    }
+    _arbUnlock();
+}
+
+#endif
+
+#ifdef   __PRESSURE_DRV_UART__
+
+/* Stream reset function */
+void pressure_streamReset()
+{
+    _txHead = 0;
+    _txTail = 0;
+    _txSequence = 0;
+    _rxCount = 0;
+
+    _streamStats.frames = 0;
+    _streamStats.overflows = 0;
+    _streamStats.commands = 0;
+    _streamStats.rxErrors = 0;
+}
+
+/* Stream sample function */
+uint8_t pressure_streamSample()
+{
+    uint8_t image[ 5 ];
+    uint8_t err;
+
+#ifdef   __PRESSURE_IDLE__
+    _idleTouch();
+#endif
+    err = pressure_readBytes( _PRESSURE_PRESS_POUT_XLB_REH, image, 5 );
+
+    if ( err != _PRESSURE_OK )
+    {
+        return err;
+    }
+
+    if ( _streamFrame( _PRESSURE_FRAME_SAMPLE, image, 5 ) != 0 )
+    {
+        _streamStats.frames++;
+    }
+
+    return _PRESSURE_OK;
+}
+
+/* Stream TX interrupt function */
+uint8_t pressure_streamTxIsr()
+{
+    uint8_t tail;
+
+    tail = _txTail;
+
+    if ( tail == _txHead )
+    {
+        return 0;
+    }
+
+    hal_uartWrite( _txRing[ tail ] );
+    _txTail = ( tail + 1 ) % _PRESSURE_STREAM_RING_SIZE;
+
+    return 1;
+}
+
+/* Stream TX span function */
+uint8_t pressure_streamTxSpan( uint8_t **span )
+{
+    uint8_t head;
+    uint8_t tail;
+
+    head = _txHead;
+    tail = _txTail;
+    *span = &_txRing[ tail ];
+
+    if ( head >= tail )
+    {
+        return head - tail;
+    }
+
+    return _PRESSURE_STREAM_RING_SIZE - tail;
+}
+
+/* Stream TX advance function */
+void pressure_streamTxAdvance( uint8_t nBytes )
+{
+    _txTail = ( _txTail + nBytes ) % _PRESSURE_STREAM_RING_SIZE;
+}
+
+/* Stream RX service function */
+uint8_t pressure_streamRxService()
+{
+    uint8_t nCommands;
+    uint8_t rxByte;
+
+    nCommands = 0;
+
+    while ( hal_uartReady() != 0 )
+    {
+        rxByte = hal_uartRead();
+
+        if ( _rxCount == 0 && rxByte != _PRESSURE_FRAME_SYNC )
+        {
+            continue;
+        }
+
+        _rxFrame[ _rxCount++ ] = rxByte;
+
+        if ( _rxCount == 4 && _rxFrame[ 3 ] > _PRESSURE_STREAM_MAX_PAYLOAD )
+        {
+            _streamStats.rxErrors++;
+            _rxCount = 0;
+
+            continue;
+        }
+
+        if ( _rxCount < 4 || _rxCount < _rxFrame[ 3 ] + 5 )
+        {
+            continue;
+        }
+
+        //  complete frame, last byte is CRC over type, sequence, length and payload
+        if ( _crc8( 0, &_rxFrame[ 1 ], _rxFrame[ 3 ] + 3 ) == rxByte )
+        {
+            _streamCommand();
+            nCommands++;
+        }
+        else
+        {
+            _streamStats.rxErrors++;
+        }
+
+        _rxCount = 0;
+    }
+
+    return nCommands;
+}
+
+/* Get stream statistics function */
+void pressure_streamGetStats( T_pressure_streamStats *stats )
+{
+    stats->frames = _streamStats.frames;
+    stats->overflows = _streamStats.overflows;
+    stats->commands = _streamStats.commands;
+    stats->rxErrors = _streamStats.rxErrors;
+}
+
+#endif
+
+#ifdef   __PRESSURE_IDLE__
+
+/* Set idle timeout function */
+void pressure_idleSetTimeout( uint32_t idleTicks )
+{
+    _idleTimeout = idleTicks;
+    _idleLastRead = _getTick();
+}
+
+/* Idle service function */
+uint8_t pressure_idleService()
+{
+    uint32_t now;
+    uint8_t err;
+
+    if ( _idleTimeout == 0 || _idleAsleep != 0 )
+    {
+        return _PRESSURE_OK;
+    }
+
+    now = _getTick();
+
+    if ( now - _idleLastRead < _idleTimeout )
+    {
+        return _PRESSURE_OK;
+    }
+
+    err = pressure_powerDown();
+
+    if ( err != _PRESSURE_OK )
+    {
+        return err;
+    }
+
+    _idleAsleep = 1;
+    _idleStats.activeTicks += now - _idleSince;
+    _idleSince = now;
+    _idleStats.powerDowns++;
+
+    return _PRESSURE_OK;
+}
+
+/* Get idle statistics function */
+void pressure_idleGetStats( T_pressure_idleStats *stats )
+{
+    uint32_t current;
+
+    current = _getTick() - _idleSince;
+
+    stats->powerDowns = _idleStats.powerDowns;
+    stats->wakes = _idleStats.wakes;
+    stats->wakeTicks = _idleStats.wakeTicks;
+    stats->maxWakeTicks = _idleStats.maxWakeTicks;
+    stats->activeTicks = _idleStats.activeTicks;
+    stats->sleepTicks = _idleStats.sleepTicks;
+
+    if ( _idleAsleep != 0 )
+    {
+        stats->sleepTicks += current;
+    }
+    else
+    {
+        stats->activeTicks += current;
+    }
+}
+
+/* Reset idle statistics function */
+void pressure_idleResetStats()
+{
+    _idleStats.powerDowns = 0;
+    _idleStats.wakes = 0;
+    _idleStats.wakeTicks = 0;
+    _idleStats.maxWakeTicks = 0;
+    _idleStats.activeTicks = 0;
+    _idleStats.sleepTicks = 0;
+    _idleSince = _getTick();
+}
+
+#endif
+
+#ifdef   __PRESSURE_RESAMPLER__
+
+/* Resampler init function */
+uint8_t pressure_resamplerInit( T_pressure_resampler *rs, uint8_t mode, uint32_t gridStart, uint32_t gridPeriod )
+{
+    if ( mode > _PRESSURE_RESAMPLE_CUBIC || gridPeriod == 0 )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    rs->mode = mode;
+    rs->count = 0;
+    rs->period = gridPeriod;
+    rs->next = gridStart;
+    rs->skipped = 0;
+
+    return _PRESSURE_OK;
+}
+
+/* Resampler push function */
+uint8_t pressure_resamplerPush( T_pressure_resampler *rs, T_pressure_sample *sample, uint32_t *output, uint8_t maxOutput )
+{
+    uint8_t nOutput;
+    uint8_t first;
+    uint8_t cnt;
+    uint8_t shift;
+    uint16_t u;
+    uint32_t span;
+    uint32_t fraction;
+    int32_t d0;
+    int32_t d2;
+    int32_t d3;
+    int32_t c1;
+    int32_t c2;
+    int32_t c3;
+    int32_t delta;
+
+    if ( rs->count != 0 && ( int32_t )( sample->timestamp - rs->tick[ rs->count - 1 ] ) <= 0 )
+    {
+        return 0;
+    }
+
+    if ( rs->count == 4 )
+    {
+        for ( cnt = 0; cnt < 3; cnt++ )
+        {
+            rs->tick[ cnt ] = rs->tick[ cnt + 1 ];
+            rs->value[ cnt ] = rs->value[ cnt + 1 ];
+        }
+        rs->count = 3;
+    }
+
+    rs->tick[ rs->count ] = sample->timestamp;
+    rs->value[ rs->count ] = ( int32_t )( sample->pressure & 0x00FFFFFF );
+    rs->count++;
+
+    //  interpolation interval [ tick[ first ], tick[ first + 1 ] )
+    if ( rs->mode == _PRESSURE_RESAMPLE_CUBIC )
+    {
+        if ( rs->count < 4 )
+        {
+            return 0;
+        }
+        first = 1;
+    }
+    else
+    {
+        if ( rs->count < 2 )
+        {
+            return 0;
+        }
+        first = rs->count - 2;
+    }
+
+    span = rs->tick[ first + 1 ] - rs->tick[ first ];
+
+    //  keep the Q16 fraction numerator below 2^31
+    shift = 0;
+    while ( ( span >> shift ) >= 0x8000 )
+    {
+        shift++;
+    }
+
+    //  differences relative to the interval start keep the products small
+    d2 = rs->value[ first + 1 ] - rs->value[ first ];
+    c1 = 0;
+    c2 = 0;
+    c3 = 0;
+
+    if ( rs->mode == _PRESSURE_RESAMPLE_CUBIC )
+    {
+        d0 = rs->value[ 0 ] - rs->value[ 1 ];
+        d3 = rs->value[ 3 ] - rs->value[ 1 ];
+
+        c1 = d2 - d0;
+        c2 = 2 * d0 + 4 * d2 - d3;
+        c3 = d3 - d0 - 3 * d2;
+    }
+
+    nOutput = 0;
+
+    while ( ( int32_t )( rs->next - rs->tick[ first + 1 ] ) < 0 )
+    {
+        if ( ( int32_t )( rs->next - rs->tick[ first ] ) < 0 || nOutput == maxOutput )
+        {
+            rs->next += rs->period;
+            rs->skipped++;
+
+            continue;
+        }
+
+        //  truncated span can make the fraction reach 1.0, it would wrap to 0
+        fraction = ( ( ( rs->next - rs->tick[ first ] ) >> shift ) << 16 ) / ( span >> shift );
+        u = ( fraction > 0xFFFF ) ? 0xFFFF : ( uint16_t ) fraction;
+
+        if ( rs->mode == _PRESSURE_RESAMPLE_CUBIC )
+        {
+            //  Catmull-Rom : ( c1 u + c2 u^2 + c3 u^3 ) / 2
+            delta = _mulFrac( c1 + _mulFrac( c2 + _mulFrac( c3, u ), u ), u );
+            delta = ( delta + ( delta >= 0 ? 1 : -1 ) ) / 2;
+        }
+        else
+        {
+            delta = _mulFrac( d2, u );
+        }
+
+        delta += rs->value[ first ];
+
+        if ( delta < 0 )
+        {
+            delta = 0;
+        }
+        if ( delta > 0x00FFFFFF )
+        {
+            delta = 0x00FFFFFF;
+        }
+
+        output[ nOutput++ ] = ( uint32_t ) delta;
+        rs->next += rs->period;
+    }
+
+    return nOutput;
+}
+
+#endif
+
+#ifdef   __PRESSURE_RATE__
+#define _RATE_RESTART_STEP      4096
+
+/*
+ * The window restarts on a step of _RATE_RESTART_STEP counts, so relative to the newest
+ * sample |y_i| <= 4095 ( W - 1 - i ). ( W - 1 ) sumY and 2 sumIY then each stay within
+ * 4095 W ( W - 1 )^2 / 2 and the numerator within their sum, 1.04e9 at W = 64, inside
+ * int32_t and the 2^30 input range of _mulQ24(). The largest numerator, 1.79e8 at W = 64,
+ * comes from a steady ramp of 4095 counts per sample.
+ */
+#if ( ( _RATE_RESTART_STEP - 1L ) * _PRESSURE_RATE_WINDOW * ( _PRESSURE_RATE_WINDOW - 1 ) * ( _PRESSURE_RATE_WINDOW - 1 ) ) >= 0x40000000L
+#error   _PRESSURE_RATE_WINDOW too large for the 32-bit slope numerator
+#endif
+
+/* Rate estimator init function */
+uint8_t pressure_rateInit( T_pressure_rate *est, uint16_t sampleRate )
+{
+    uint32_t rateFactor;
+    uint32_t moment;
+
+    if ( sampleRate < 100 || sampleRate > 2500 )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    //  slope = 6 * ( 2 * sumIY - ( N - 1 ) * sumY ) / ( N ( N^2 - 1 ) ) counts per sample,
+    //  mPa/s = slope * sampleRate / 100 * 100000 / 4096
+    moment = ( uint32_t ) _PRESSURE_RATE_WINDOW * ( ( uint32_t ) _PRESSURE_RATE_WINDOW * _PRESSURE_RATE_WINDOW - 1 );
+    rateFactor = ( uint32_t ) sampleRate * 6000;
+
+    est->scale = ( ( rateFactor / moment ) << 12 ) + ( ( ( rateFactor % moment ) << 12 ) / moment );
+    est->oldest = 0;
+    est->count = 0;
+    est->reference = 0;
+    est->sumY = 0;
+    est->sumIY = 0;
+
+    return _PRESSURE_OK;
+}
+
+/* Rate estimator update function */
+uint8_t pressure_rateUpdate( T_pressure_rate *est, uint32_t rawPressure, T_pressure_rateResult *result )
+{
+    int32_t delta;
+    int32_t numerator;
+    int32_t rate;
+    uint32_t pascal;
+    uint32_t heightFactor;
+    uint32_t magnitude;
+
+    rawPressure &= 0x00FFFFFF;
+    delta = ( int32_t ) rawPressure - ( int32_t ) est->reference;
+
+    if ( est->count != 0 && ( delta >= _RATE_RESTART_STEP || delta <= -_RATE_RESTART_STEP ) )
+    {
+        est->count = 0;
+        est->sumY = 0;
+        est->sumIY = 0;
+    }
+
+    if ( est->count == _PRESSURE_RATE_WINDOW )
+    {
+        //  drop the oldest ( position 0 ), the others move one position down
+        est->sumY -= ( int32_t ) est->window[ est->oldest ] - ( int32_t ) est->reference;
+        est->sumIY -= est->sumY;
+        est->oldest = ( est->oldest + 1 ) % _PRESSURE_RATE_WINDOW;
+        est->count--;
+    }
+
+    //  move the reference to the new sample, it then adds nothing to the sums
+    if ( est->count != 0 )
+    {
+        est->sumY -= delta * est->count;
+        est->sumIY -= delta * ( ( est->count * ( est->count - 1 ) ) / 2 );
+    }
+    est->reference = rawPressure;
+
+    est->window[ ( est->oldest + est->count ) % _PRESSURE_RATE_WINDOW ] = rawPressure;
+    est->count++;
+
+    if ( est->count < _PRESSURE_RATE_WINDOW )
+    {
+        return 0;
+    }
+
+    numerator = 2 * est->sumIY - ( _PRESSURE_RATE_WINDOW - 1 ) * est->sumY;
+
+    if ( numerator < 0 )
+    {
+        rate = -( int32_t ) _mulQ24( ( uint32_t )( -numerator ), est->scale );
+    }
+    else
+    {
+        rate = ( int32_t ) _mulQ24( ( uint32_t ) numerator, est->scale );
+    }
+
+    //  scale height over the mean pressure in mm/Pa, Q4
+    pascal = pressure_rawToPascal( ( uint32_t )( ( int32_t ) est->reference + est->sumY / _PRESSURE_RATE_WINDOW ) );
+    heightFactor = ( pascal != 0 ) ? 134952000 / pascal : 0;
+
+    result->pressureRate = rate;
+
+    if ( rate > 1500000 || rate < -1500000 )
+    {
+        rate = ( rate > 0 ) ? 1500000 : -1500000;
+    }
+
+    //  rate * heightFactor overflows 32 bits at altitude, divide in two parts
+    magnitude = ( uint32_t )( ( rate < 0 ) ? -rate : rate );
+    magnitude = ( magnitude / 16000 ) * heightFactor + ( ( magnitude % 16000 ) * heightFactor ) / 16000;
+    result->verticalSpeed = ( rate < 0 ) ? ( int32_t ) magnitude : -( int32_t ) magnitude;
+
+    return 1;
+}
+
+#endif
+
+#ifdef   __PRESSURE_KALMAN__
+
+/* Kalman filter init function */
+uint8_t pressure_kalmanInit( T_pressure_kalman *kf, uint8_t resConfig, uint8_t outDataRate, float accelNoise )
+{
+    float dt2;
+    float variance;
+    uint16_t nAverages;
+
+    switch ( outDataRate % 8 )
+    {
+        case 1 :
+            kf->dt = 1.0f;
+        break;
+        case 2 :
+        case 5 :
+            kf->dt = 0.142857143f;
+        break;
+        case 3 :
+        case 6 :
+            kf->dt = 0.08f;
+        break;
+        case 4 :
+        case 7 :
+            kf->dt = 0.04f;
+        break;
+        default :
+            return _PRESSURE_ERR_PARAM;
+    }
+
+    if ( accelNoise <= 0.0f )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    //  AVGP 0 .. 8 : 2^n averages, 9 : 384, above : 512
+    resConfig &= 0x0F;
+
+    if ( resConfig < 9 )
+    {
+        nAverages = ( uint16_t ) 1 << resConfig;
+    }
+    else if ( resConfig == 9 )
+    {
+        nAverages = 384;
+    }
+    else
+    {
+        nAverages = 512;
+    }
+
+    //  white acceleration model
+    dt2 = kf->dt * kf->dt;
+    variance = accelNoise * accelNoise;
+
+    kf->q00 = dt2 * dt2 * 0.25f * variance;
+    kf->q01 = dt2 * kf->dt * 0.5f * variance;
+    kf->q11 = dt2 * variance;
+    kf->r = 2025.0f / ( float ) nAverages;
+    kf->altitude = 0.0f;
+    kf->velocity = 0.0f;
+    kf->base = 0.0f;
+    kf->reference = 0;
+
+    return _PRESSURE_OK;
+}
+
+/* Kalman filter update function */
+void pressure_kalmanUpdate( T_pressure_kalman *kf, uint32_t rawPressure )
+{
+    float x;
+    float innovation;
+    float gain0;
+    float gain1;
+    float p01;
+
+    rawPressure &= 0x00FFFFFF;
+
+    if ( kf->reference == 0 )
+    {
+        //  measurement noise to m^2 at the reference, 4096 counts per mbar
+        x = 8434.5f * 40.96f / ( float ) rawPressure;
+
+        kf->reference = rawPressure;
+        kf->r *= x * x;
+        kf->p00 = kf->r;
+        kf->p01 = 0.0f;
+        kf->p11 = 100.0f;
+
+        return;
+    }
+
+    //  h = H ln( P0 / P ) = -H ( x - x^2 / 2 + x^3 / 3 ), x = P / P0 - 1
+    x = ( float ) ( ( int32_t ) rawPressure - ( int32_t ) kf->reference ) / ( float ) kf->reference;
+    innovation = kf->base - 8434.5f * x * ( 1.0f - x * ( 0.5f - x * 0.333333333f ) );
+
+    //  the truncation error grows as x^4 ( 17 m at 3 km from a fixed reference ),
+    //  past 1/64 of the reference pressure move the reference, each move adds under 0.2 mm
+    if ( x > 0.015625f || x < -0.015625f )
+    {
+        x = ( float ) kf->reference / ( float ) rawPressure;
+
+        kf->reference = rawPressure;
+        kf->base = innovation;
+        kf->r *= x * x;
+    }
+
+    //  predict
+    kf->altitude += kf->velocity * kf->dt;
+    kf->p00 += kf->dt * ( 2.0f * kf->p01 + kf->dt * kf->p11 ) + kf->q00;
+    kf->p01 += kf->dt * kf->p11 + kf->q01;
+    kf->p11 += kf->q11;
+
+    //  correct
+    innovation -= kf->altitude;
+    gain0 = 1.0f / ( kf->p00 + kf->r );
+    gain1 = kf->p01 * gain0;
+    gain0 *= kf->p00;
+    p01 = kf->p01;
+
+    kf->altitude += gain0 * innovation;
+    kf->velocity += gain1 * innovation;
+    kf->p11 -= gain1 * p01;
+    kf->p01 -= gain0 * p01;
+    kf->p00 -= gain0 * kf->p00;
+}
+
+#endif
+
+#ifdef   __PRESSURE_MEDIAN__
+
+/* Median filter init function */
+void pressure_medianInit( T_pressure_median *mf )
+{
+    uint8_t cnt;
+    uint8_t index;
+
+    //  slots 0, 1, 2, 3 .. start at the centre, then one below, one above, two below ..
+    for ( cnt = 0; cnt < _PRESSURE_MEDIAN_WINDOW; cnt++ )
+    {
+        if ( cnt & 1 )
+        {
+            index = _MEDIAN_CENTRE - ( cnt + 1 ) / 2;
+        }
+        else
+        {
+            index = _MEDIAN_CENTRE + cnt / 2;
+        }
+
+        mf->data[ cnt ] = 0;
+        mf->pos[ cnt ] = index;
+        mf->heap[ index ] = cnt;
+    }
+
+    mf->next = 0;
+    mf->count = 0;
+}
+
+/* Median filter push function */
+uint32_t pressure_medianPush( T_pressure_median *mf, uint32_t rawPressure )
+{
+    uint8_t full;
+    uint8_t index;
+    uint8_t k;
+    uint32_t old;
+
+    rawPressure &= 0x00FFFFFF;
+
+    full = ( mf->count == _PRESSURE_MEDIAN_WINDOW );
+    index = mf->pos[ mf->next ];
+    old = mf->data[ mf->next ];
+
+    mf->data[ mf->next ] = rawPressure;
+    mf->next = ( mf->next + 1 ) % _PRESSURE_MEDIAN_WINDOW;
+
+    if ( !full )
+    {
+        mf->count++;
+    }
+
+    if ( index > _MEDIAN_CENTRE )
+    {
+        k = index - _MEDIAN_CENTRE;
+
+        if ( full && old < rawPressure )
+        {
+            _medianMinDown( mf, k * 2 );
+        }
+        else if ( _medianMinUp( mf, k ) )
+        {
+            _medianMaxDown( mf, 1 );
+        }
+    }
+    else if ( index < _MEDIAN_CENTRE )
+    {
+        k = _MEDIAN_CENTRE - index;
+
+        if ( full && rawPressure < old )
+        {
+            _medianMaxDown( mf, k * 2 );
+        }
+        else if ( _medianMaxUp( mf, k ) )
+        {
+            _medianMinDown( mf, 1 );
+        }
+    }
+    else
+    {
+        if ( mf->count / 2 )
+        {
+            _medianMaxDown( mf, 1 );
+        }
+        if ( ( mf->count - 1 ) / 2 )
+        {
+            _medianMinDown( mf, 1 );
+        }
+    }
+
+    return mf->data[ mf->heap[ _MEDIAN_CENTRE ] ];
+}
+
+#endif
+
+#ifdef   __PRESSURE_BATCH__
+
+/* Batch setup function */
+uint8_t pressure_batchSetup( uint8_t source, uint8_t watermark, uint32_t maxAge, T_pressure_batchFp batchFp )
+{
+    if ( source > _PRESSURE_BATCH_POLL_INT || watermark == 0 || watermark > _PRESSURE_BATCH_SIZE )
+    {
+        return _PRESSURE_ERR_PARAM;
+    }
+
+    _batchSource = source;
+    _batchWatermark = watermark;
+    _batchMaxAge = maxAge;
+    _batchFp = batchFp;
+    _batchCount = 0;
+
+    return _PRESSURE_OK;
+}
+
+/* Batch service function */
+uint8_t pressure_batchService()
+{
+    uint8_t status;
+    uint8_t ready;
+
+    status = 0;
+
+    if ( _batchSource == _PRESSURE_BATCH_POLL_INT )
+    {
+        ready = _intGet();
+
+        //  STATUS only for P_OR, read once the pin reports new data
+        if ( ready && pressure_readRegister( _PRESSURE_STATUS_REG, &status ) != _PRESSURE_OK )
+        {
+            status = 0;
+        }
+    }
+    else
+    {
+        if ( pressure_readRegister( _PRESSURE_STATUS_REG, &status ) != _PRESSURE_OK )
+        {
+            status = 0;
+        }
+
+        ready = status & 0x02;
+    }
+
+    if ( ready && _batchCount < _PRESSURE_BATCH_SIZE )
+    {
+        if ( pressure_readSample( &_batch[ _batchCount ] ) == _PRESSURE_OK )
+        {
+            _batchCount++;
+            _batchStats.samples++;
+
+            if ( status & 0x20 )
+            {
+                _batchStats.overruns++;
+            }
+        }
+    }
+
+    if ( _batchCount >= _batchWatermark )
+    {
+        return pressure_batchFlush();
+    }
+
+    if ( _batchCount != 0 && _batchMaxAge != 0 && _getTick() - _batch[ 0 ].timestamp >= _batchMaxAge )
+    {
+        _batchStats.ageFlushes++;
+
+        return pressure_batchFlush();
+    }
+
+    return 0;
+}
+
+/* Batch flush function */
+uint8_t pressure_batchFlush()
+{
+    uint8_t nSamples;
+
+    nSamples = _batchCount;
+
+    if ( nSamples == 0 )
+    {
+        return 0;
+    }
+
+    _batchCount = 0;
+    _batchStats.batches++;
+
+    if ( _batchFp != 0 )
+    {
+        _batchFp( _batch, nSamples );
+    }
+
+    return nSamples;
+}
+
+/* Get batch statistics function */
+void pressure_batchGetStats( T_pressure_batchStats *stats )
+{
+    stats->samples = _batchStats.samples;
+    stats->batches = _batchStats.batches;
+    stats->ageFlushes = _batchStats.ageFlushes;
+    stats->overruns = _batchStats.overruns;
+}
+
+/* Reset batch statistics function */
+void pressure_batchResetStats()
+{
+    _batchStats.samples = 0;
+    _batchStats.batches = 0;
+    _batchStats.ageFlushes = 0;
+    _batchStats.overruns = 0;
+}
+
+#endif
 
 /* -------------------------------------------------------------------------- */
 /*
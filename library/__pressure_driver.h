@@ -35,6 +35,7 @@
 /* -------------------------------------------------------------------------- */
 
 #include "stdint.h"
+#include "stddef.h"
 
 #ifndef _PRESSURE_H_
 #define _PRESSURE_H_
@@ -49,12 +50,46 @@
 
    #define   __PRESSURE_DRV_SPI__                            /**<     @macro __PRESSURE_DRV_SPI__  @brief SPI driver selector */
    #define   __PRESSURE_DRV_I2C__                            /**<     @macro __PRESSURE_DRV_I2C__  @brief I2C driver selector */                                          
-// #define   __PRESSURE_DRV_UART__                           /**<     @macro __PRESSURE_DRV_UART__ @brief UART driver selector */ 
+// #define   __PRESSURE_DRV_UART__                           /**<     @macro __PRESSURE_DRV_UART__ @brief UART binary streaming selector */ 
+// #define   __PRESSURE_BUS_RECOVERY__                       /**<     @macro __PRESSURE_BUS_RECOVERY__ @brief I2C bus recovery ( SCL pulses ) selector */
+// #define   __PRESSURE_LATENCY__                            /**<     @macro __PRESSURE_LATENCY__ @brief Data-ready to consumption latency histogram selector */
+
+// #define   __PRESSURE_SCHEDULER__                          /**<     @macro __PRESSURE_SCHEDULER__ @brief Tickless cooperative scheduler selector */
+
+// #define   __PRESSURE_TRACE__                              /**<     @macro __PRESSURE_TRACE__ @brief Register traffic capture selector */
+// #define   __PRESSURE_HAL_REPLAY__                         /**<     @macro __PRESSURE_HAL_REPLAY__ @brief Trace replay HAL selector ( host builds ) */
+
+// #define   __PRESSURE_STATS__                              /**<     @macro __PRESSURE_STATS__ @brief Streaming statistics selector */
+
+// #define   __PRESSURE_DECIMATOR__                          /**<     @macro __PRESSURE_DECIMATOR__ @brief CIC + FIR decimation selector */
+
+// #define   __PRESSURE_CALIBRATION__                        /**<     @macro __PRESSURE_CALIBRATION__ @brief Offset/gain/tempco calibration selector */
+
+// #define   __PRESSURE_VERIFY_WRITES__                      /**<     @macro __PRESSURE_VERIFY_WRITES__ @brief Warm start write verification selector */
+
+// #define   __PRESSURE_BUS_ARBITER__                        /**<     @macro __PRESSURE_BUS_ARBITER__ @brief Shared bus arbitration selector */
+
+// #define   __PRESSURE_TXN_QUEUE__                          /**<     @macro __PRESSURE_TXN_QUEUE__ @brief Merging transaction queue selector */
+
+// #define   __PRESSURE_IDLE__                               /**<     @macro __PRESSURE_IDLE__ @brief Idle power-down manager selector */
+
+// #define   __PRESSURE_RESAMPLER__                          /**<     @macro __PRESSURE_RESAMPLER__ @brief Fixed time grid resampler selector */
+
+// #define   __PRESSURE_RATE__                               /**<     @macro __PRESSURE_RATE__ @brief Pressure rate / vertical speed estimator selector */
+
+// #define   __PRESSURE_KALMAN__                             /**<     @macro __PRESSURE_KALMAN__ @brief Altitude Kalman filter selector */
+
+// #define   __PRESSURE_MEDIAN__                             /**<     @macro __PRESSURE_MEDIAN__ @brief Sliding window median filter selector */
+
+// #define   __PRESSURE_BATCH__                              /**<     @macro __PRESSURE_BATCH__ @brief Batched sample delivery selector */
 
                                                                        /** @} */
 /** @defgroup PRESSURE_VAR Variables */                           /** @{ */
 
 
+extern const uint8_t  _PRESSURE_I2C_SELECT;
+extern const uint8_t  _PRESSURE_SPI_SELECT;
+
 extern const uint8_t  _PRESSURE_REF_P_XLB;
 extern const uint8_t  _PRESSURE_REF_P_LSB;
 extern const uint8_t  _PRESSURE_REF_P_MSB;
@@ -86,10 +121,538 @@ extern const uint8_t  _PRESSURE_AMP_CTRL;
 
 extern const uint8_t  _PRESSURE_I2C_ADDRESS_0;
 extern const uint8_t  _PRESSURE_I2C_ADDRESS_1;
+
+extern const uint8_t  _PRESSURE_OK;
+extern const uint8_t  _PRESSURE_ERR_BUS;
+extern const uint8_t  _PRESSURE_ERR_PARAM;
+extern const uint8_t  _PRESSURE_ERR_VERIFY;
+
+extern const uint8_t  _PRESSURE_TIMESTAMP_AT_READ;
+extern const uint8_t  _PRESSURE_TIMESTAMP_AT_INT;
+
+#ifdef   __PRESSURE_LATENCY__
+#define  _PRESSURE_LATENCY_BUCKETS      16
+#define  _PRESSURE_LATENCY_IMAGE_SIZE   ( 3 * 2 * _PRESSURE_LATENCY_BUCKETS )
+#endif
+#ifdef   __PRESSURE_SCHEDULER__
+#define  _PRESSURE_SCHED_MAX_TASKS      4
+
+extern const uint8_t  _PRESSURE_SCHED_NO_TASK;
+extern const uint32_t _PRESSURE_SCHED_UNTIL_INT;
+#endif
+#ifdef   __PRESSURE_TXN_QUEUE__
+#define  _PRESSURE_QUEUE_SIZE           8
+#define  _PRESSURE_QUEUE_CACHE          2
+#define  _PRESSURE_QUEUE_MAX_BYTES      6
+
+extern const uint8_t  _PRESSURE_QUEUE_NO_SLOT;
+#endif
+
+extern const uint8_t  _PRESSURE_PROFILE_ULTRA_LOW_POWER;
+extern const uint8_t  _PRESSURE_PROFILE_BALANCED;
+extern const uint8_t  _PRESSURE_PROFILE_HIGH_RESOLUTION;
+extern const uint8_t  _PRESSURE_PROFILE_HIGH_RATE;
+
+extern const uint8_t  _PRESSURE_FIELD_PD;
+extern const uint8_t  _PRESSURE_FIELD_ODR;
+extern const uint8_t  _PRESSURE_FIELD_DIFF_EN;
+extern const uint8_t  _PRESSURE_FIELD_BDU;
+extern const uint8_t  _PRESSURE_FIELD_DELTA_EN;
+extern const uint8_t  _PRESSURE_FIELD_SIM;
+extern const uint8_t  _PRESSURE_FIELD_BOOT;
+extern const uint8_t  _PRESSURE_FIELD_SWRESET;
+extern const uint8_t  _PRESSURE_FIELD_AUTO_ZERO;
+extern const uint8_t  _PRESSURE_FIELD_ONE_SHOT;
+extern const uint8_t  _PRESSURE_FIELD_INT_H_L;
+extern const uint8_t  _PRESSURE_FIELD_PP_OD;
+extern const uint8_t  _PRESSURE_FIELD_INT2_S;
+extern const uint8_t  _PRESSURE_FIELD_INT1_S;
+extern const uint8_t  _PRESSURE_FIELD_AVGT;
+extern const uint8_t  _PRESSURE_FIELD_AVGP;
+extern const uint8_t  _PRESSURE_FIELD_LIR;
+extern const uint8_t  _PRESSURE_FIELD_PL_E;
+extern const uint8_t  _PRESSURE_FIELD_PH_E;
+extern const uint8_t  _PRESSURE_FIELD_SELMAIN;
+
+#ifdef   __PRESSURE_DRV_UART__
+#define  _PRESSURE_STREAM_RING_SIZE     64
+#define  _PRESSURE_STREAM_MAX_PAYLOAD   6
+
+extern const uint8_t  _PRESSURE_FRAME_SYNC;
+extern const uint8_t  _PRESSURE_FRAME_SAMPLE;
+extern const uint8_t  _PRESSURE_FRAME_ACK;
+extern const uint8_t  _PRESSURE_CMD_SET_ODR;
+extern const uint8_t  _PRESSURE_CMD_SET_PROFILE;
+#endif
+
+#ifdef   __PRESSURE_RESAMPLER__
+extern const uint8_t  _PRESSURE_RESAMPLE_LINEAR;
+extern const uint8_t  _PRESSURE_RESAMPLE_CUBIC;
+#endif
+
+#ifdef   __PRESSURE_RATE__
+#ifndef  _PRESSURE_RATE_WINDOW
+#define  _PRESSURE_RATE_WINDOW          16
+#endif
+#if ( _PRESSURE_RATE_WINDOW < 4 ) || ( _PRESSURE_RATE_WINDOW > 64 )
+#error   _PRESSURE_RATE_WINDOW must be 4 to 64 samples
+#endif
+#endif
+
+#ifdef   __PRESSURE_MEDIAN__
+#ifndef  _PRESSURE_MEDIAN_WINDOW
+#define  _PRESSURE_MEDIAN_WINDOW        5
+#endif
+#if ( _PRESSURE_MEDIAN_WINDOW < 5 ) || ( _PRESSURE_MEDIAN_WINDOW > 63 ) || ( _PRESSURE_MEDIAN_WINDOW % 2 == 0 )
+#error   _PRESSURE_MEDIAN_WINDOW must be odd, 5 to 63 samples
+#endif
+#endif
+
+#ifdef   __PRESSURE_BATCH__
+#define  _PRESSURE_BATCH_SIZE           16
+
+extern const uint8_t  _PRESSURE_BATCH_POLL_STATUS;
+extern const uint8_t  _PRESSURE_BATCH_POLL_INT;
+#endif
+
                                                                        /** @} */
 /** @defgroup PRESSURE_TYPES Types */                             /** @{ */
 
+/**
+ * @brief Tick source function type
+ *
+ * User supplied function which returns a free running, monotonic tick counter.
+ */
+typedef uint32_t (*T_pressure_tickFp)();
+
+/**
+ * @brief Raw sample structure
+ */
+typedef struct
+{
+    uint32_t    pressure;                   /**< Raw 24-bit pressure counts */
+    int16_t     temperature;                /**< Raw 16-bit temperature counts */
+    uint32_t    timestamp;                  /**< Tick value at which the sample was taken */
+#ifdef   __PRESSURE_LATENCY__
+    uint32_t    readyTick;                  /**< Tick value of the data ready edge */
+    uint32_t    readTick;                   /**< Tick value at the end of the register read */
+#endif
+
+}T_pressure_sample;
+
+/**
+ * @brief Sample interval jitter statistics structure
+ */
+typedef struct
+{
+    uint32_t    nIntervals;                 /**< Number of measured intervals */
+    uint32_t    minInterval;                /**< Shortest interval in ticks */
+    uint32_t    maxInterval;                /**< Longest interval in ticks */
+    float       meanInterval;               /**< Mean interval in ticks */
+    float       variance;                   /**< Interval variance in ticks^2 */
+
+}T_pressure_jitterStats;
+
+/**
+ * @brief Bus statistics structure
+ */
+typedef struct
+{
+    uint32_t    transactions;               /**< Number of requested bus transactions */
+    uint32_t    errors;                     /**< Number of transactions failed after all retries */
+    uint32_t    retries;                    /**< Number of retried transactions */
+    uint32_t    recoveries;                 /**< Number of bus recoveries which released a stuck SDA */
+    uint32_t    errorTicks;                 /**< Ticks spent in failing transactions and retries */
+
+}T_pressure_busStats;
+
+#ifdef   __PRESSURE_LATENCY__
+/**
+ * @brief Text output function type
+ *
+ * User supplied function which outputs one zero terminated line of text.
+ */
+typedef void (*T_pressure_putsFp)(char*);
+#endif
+
+#ifdef   __PRESSURE_SCHEDULER__
+/**
+ * @brief Scheduler task function type
+ */
+typedef void (*T_pressure_taskFp)();
+
+/**
+ * @brief Scheduler sleep hook type
+ *
+ * User supplied function which puts the MCU to sleep for at most nTicks ticks
+ * ( or until an interrupt ). nTicks equal to _PRESSURE_SCHED_UNTIL_INT means
+ * only data ready tasks wait, sleep until the INT pin interrupt.
+ * On host builds it can simply advance the simulated tick counter.
+ */
+typedef void (*T_pressure_sleepFp)(uint32_t);
+
+/**
+ * @brief Scheduler task statistics structure
+ */
+typedef struct
+{
+    uint32_t    nRuns;                      /**< Number of task executions */
+    uint32_t    nMissed;                    /**< Number of executions finished after the deadline */
+    uint32_t    maxLateness;                /**< Longest start delay after release in ticks */
+
+}T_pressure_taskStats;
+#endif
+
+/**
+ * @brief Power profile structure
+ */
+typedef struct
+{
+    uint8_t     outDataRate;                /**< Output data rate code ( CTRL_REG1 ODR ) */
+    uint8_t     resConfig;                  /**< Pressure/temperature averaging ( RES_CONF ) */
+    uint8_t     ampCtrl;                    /**< Analog front end control ( AMP_CTRL ) */
+    float       supplyCurrent;              /**< Estimated supply current in uA */
+    float       noise;                      /**< Estimated pressure noise in mbar RMS */
+
+}T_pressure_profileInfo;
+
+#ifdef   __PRESSURE_TRACE__
+/**
+ * @brief Trace sink function type
+ *
+ * User supplied function which stores one binary trace record.
+ */
+typedef void (*T_pressure_traceFp)(uint8_t*, uint8_t);
+#endif
+
+#ifdef   __PRESSURE_STATS__
+/**
+ * @brief Streaming statistics accumulator structure
+ *
+ * Accumulates exact integer sums of raw counts of one channel relative to the first sample,
+ * converted to physical units only on readout. The sums are 64-bit, kept as two 32-bit
+ * words since 8-bit compilers have no 64-bit integer type.
+ */
+typedef struct
+{
+    uint32_t    count;                      /**< Number of accumulated samples */
+    int32_t     ref;                        /**< First sample, accumulated values are relative to it */
+    int32_t     min;                        /**< Minimal raw value */
+    int32_t     max;                        /**< Maximal raw value */
+    uint32_t    sumHi;                      /**< Sum of deviations from ref, two's complement high word */
+    uint32_t    sumLo;                      /**< Sum of deviations from ref, low word */
+    uint32_t    sumSqHi;                    /**< Sum of squared deviations from ref, high word */
+    uint32_t    sumSqLo;                    /**< Sum of squared deviations from ref, low word */
+
+}T_pressure_stats;
+
+/**
+ * @brief Statistics result structure
+ */
+typedef struct
+{
+    uint32_t    count;                      /**< Number of samples */
+    float       min;                        /**< Minimal value */
+    float       max;                        /**< Maximal value */
+    float       mean;                       /**< Mean value */
+    float       stdDev;                     /**< Sample standard deviation */
+
+}T_pressure_statsResult;
+#endif
+
+#ifdef   __PRESSURE_DECIMATOR__
+/**
+ * @brief Decimator state structure
+ */
+typedef struct
+{
+    uint8_t     ratio;                      /**< Decimation ratio 2..64 */
+    uint8_t     phase;                      /**< Input samples since the last output */
+    uint8_t     primed;                     /**< Reference value valid */
+    uint8_t     settle;                     /**< Outputs to suppress until the delay lines are filled */
+    uint16_t    dropped;                    /**< Output slots suppressed since init, settling and restarts */
+    int32_t     reference;                  /**< Raw value the filter input is relative to */
+    int32_t     limit;                      /**< Input deviation which forces new reference */
+    uint32_t    gain;                       /**< CIC gain ( ratio ^ 2 ) */
+    uint32_t    integrator1;                /**< CIC first integrator */
+    uint32_t    integrator2;                /**< CIC second integrator */
+    uint32_t    comb1;                      /**< CIC first comb delay */
+    uint32_t    comb2;                      /**< CIC second comb delay */
+    int32_t     fir[ 2 ];                   /**< Compensation FIR history */
+
+}T_pressure_decimator;
+#endif
+
+#ifdef   __PRESSURE_CALIBRATION__
+/**
+ * @brief Calibration record structure
+ */
+typedef struct
+{
+    int32_t     offset;                     /**< Offset in raw pressure counts */
+    uint16_t    gain;                       /**< Span correction, 0x4000 = 1.0 ( max 2.0 ) */
+    int16_t     tempco;                     /**< Raw pressure counts per 256 raw temperature counts */
+    int16_t     tempRef;                    /**< Raw temperature at which tempco correction is zero */
+
+}T_pressure_calibration;
+
+/**
+ * @brief Calibration storage function type
+ *
+ * User supplied function which loads or stores the calibration record ( e.g. EEPROM ),
+ * returns _PRESSURE_OK on success.
+ */
+typedef uint8_t (*T_pressure_calFp)(T_pressure_calibration*);
+#endif
+
+/**
+ * @brief Probe result entry structure
+ */
+typedef struct
+{
+    uint8_t     interfaceSelect;            /**< _PRESSURE_I2C_SELECT or _PRESSURE_SPI_SELECT */
+    uint8_t     slaveAddress;               /**< I2C slave address, 0 for SPI */
+
+}T_pressure_probeEntry;
+
+/**
+ * @brief Device configuration structure
+ */
+typedef struct
+{
+    uint8_t     resConfig;                  /**< _PRESSURE_RES_CONFIG value */
+    uint8_t     ctrlReg1;                   /**< _PRESSURE_CTRL_REG1 value */
+    uint8_t     ctrlReg2;                   /**< _PRESSURE_CTRL_REG2 value ( without self clearing bits ) */
+    uint8_t     ctrlReg3;                   /**< _PRESSURE_CTRL_REG3 value */
+    uint8_t     intConfig;                  /**< _PRESSURE_INT_CFG_REG value */
+    uint8_t     thsPLsb;                    /**< _PRESSURE_THS_P_LSB_REG value */
+    uint8_t     thsPMsb;                    /**< _PRESSURE_THS_P_MSB_REG value */
+
+}T_pressure_config;
+
+/**
+ * @brief Register field descriptor structure
+ */
+typedef struct
+{
+    uint8_t     regAddress;                 /**< Register address */
+    uint8_t     shift;                      /**< Position of the field LSB */
+    uint8_t     width;                      /**< Field width in bits */
+
+}T_pressure_fieldDesc;
+
+#ifdef   __PRESSURE_BUS_ARBITER__
+/**
+ * @brief Bus lock try function type
+ *
+ * User supplied function which takes the shared bus lock without blocking
+ * and returns 1 when the lock is taken.
+ */
+typedef uint8_t (*T_pressure_tryLockFp)();
+
+/**
+ * @brief Bus arbiter hook function type
+ */
+typedef void (*T_pressure_arbFp)();
+
+/**
+ * @brief Bus arbiter structure
+ */
+typedef struct
+{
+    T_pressure_tryLockFp    tryLock;        /**< Take the lock without blocking ( 0 : contention not detected ) */
+    T_pressure_arbFp        lock;           /**< Take the lock, block until available */
+    T_pressure_arbFp        unlock;         /**< Release the lock */
+    T_pressure_arbFp        inherit;        /**< Lend caller priority to the lock owner before blocking ( may be 0 ) */
+    T_pressure_arbFp        restore;        /**< Return caller to its base priority after release ( may be 0 ) */
+
+}T_pressure_arbiter;
+
+/**
+ * @brief Bus arbitration statistics structure
+ */
+typedef struct
+{
+    uint32_t    acquisitions;               /**< Number of lock acquisitions */
+    uint32_t    contentions;                /**< Number of acquisitions which found the bus taken */
+    uint32_t    waitTicks;                  /**< Ticks spent waiting for the bus */
+    uint32_t    maxWaitTicks;               /**< Longest wait for the bus */
+
+}T_pressure_arbStats;
+#endif
+
+#ifdef   __PRESSURE_TXN_QUEUE__
+/**
+ * @brief Queued read completion function type
+ *
+ * Called from pressure_queueService() with the request slot and bus status.
+ */
+typedef void (*T_pressure_doneFp)( uint8_t slot, uint8_t err );
+
+/**
+ * @brief Queued read request structure
+ */
+typedef struct
+{
+    uint8_t             regAddress;         /**< First register */
+    uint8_t             nBytes;             /**< Number of registers */
+    uint8_t             *rBuffer;           /**< Destination buffer */
+    uint32_t            deadline;           /**< Deadline tick */
+    T_pressure_doneFp   doneFp;             /**< Completion function ( may be 0 ) */
+    uint8_t             pending;            /**< Request waits for service */
+    uint8_t             notify;             /**< Completion function call pending */
+    uint8_t             err;                /**< Bus status of the completed read */
+
+}T_pressure_queueEntry;
+
+/**
+ * @brief Transaction queue statistics structure
+ */
+typedef struct
+{
+    uint32_t    requests;                   /**< Number of enqueued requests */
+    uint32_t    reads;                      /**< Number of bus reads done for the requests */
+    uint32_t    merged;                     /**< Number of requests served without own bus read */
+    uint32_t    late;                       /**< Number of requests completed after their deadline */
+
+}T_pressure_queueStats;
+#endif
+
+#ifdef   __PRESSURE_DRV_UART__
+/**
+ * @brief UART stream statistics structure
+ */
+typedef struct
+{
+    uint32_t    frames;                     /**< Number of queued sample frames */
+    uint32_t    overflows;                  /**< Number of frames dropped on full TX ring */
+    uint32_t    commands;                   /**< Number of executed inbound commands */
+    uint32_t    rxErrors;                   /**< Number of inbound frames with bad CRC or length */
+
+}T_pressure_streamStats;
+#endif
+
+#ifdef   __PRESSURE_IDLE__
+/**
+ * @brief Idle manager statistics structure
+ */
+typedef struct
+{
+    uint32_t    powerDowns;                 /**< Number of idle power-downs */
+    uint32_t    wakes;                      /**< Number of wake-ups on consumer read */
+    uint32_t    wakeTicks;                  /**< Total wake latency ( enable to first conversion ) */
+    uint32_t    maxWakeTicks;               /**< Longest wake latency */
+    uint32_t    activeTicks;                /**< Residency in active mode */
+    uint32_t    sleepTicks;                 /**< Residency in idle power-down */
+
+}T_pressure_idleStats;
+#endif
+
+#ifdef   __PRESSURE_RESAMPLER__
+/**
+ * @brief Resampler state structure
+ */
+typedef struct
+{
+    uint8_t     mode;                       /**< _PRESSURE_RESAMPLE_LINEAR or _PRESSURE_RESAMPLE_CUBIC */
+    uint8_t     count;                      /**< Valid history samples */
+    uint32_t    period;                     /**< Grid period in ticks */
+    uint32_t    next;                       /**< Next grid tick */
+    uint32_t    skipped;                    /**< Grid ticks skipped before the first sample or on output overflow */
+    uint32_t    tick[ 4 ];                  /**< Sample timestamps, oldest first */
+    int32_t     value[ 4 ];                 /**< Raw pressure counts, oldest first */
+
+}T_pressure_resampler;
+#endif
+
+#ifdef   __PRESSURE_RATE__
+/**
+ * @brief Pressure rate estimator state structure
+ */
+typedef struct
+{
+    uint32_t    window[ _PRESSURE_RATE_WINDOW ];    /**< Raw pressure counts */
+    uint8_t     oldest;                     /**< Index of the oldest sample */
+    uint8_t     count;                      /**< Number of samples in the window */
+    uint32_t    reference;                  /**< Newest sample, sums are relative to it */
+    int32_t     sumY;                       /**< Sum of samples */
+    int32_t     sumIY;                      /**< Sum of samples weighted by window position */
+    uint32_t    scale;                      /**< Slope to mPa/s factor, Q24 */
+
+}T_pressure_rate;
+
+/**
+ * @brief Pressure rate result structure
+ */
+typedef struct
+{
+    int32_t     pressureRate;               /**< Pressure rate in mPa/s */
+    int32_t     verticalSpeed;              /**< Vertical speed in mm/s, positive upwards */
+
+}T_pressure_rateResult;
+#endif
+
+#ifdef   __PRESSURE_KALMAN__
+/**
+ * @brief Altitude Kalman filter state structure
+ */
+typedef struct
+{
+    float       altitude;                   /**< Altitude above the reference in m */
+    float       velocity;                   /**< Vertical velocity in m/s, positive upwards */
+    float       p00;                        /**< Altitude variance */
+    float       p01;                        /**< Altitude / velocity covariance */
+    float       p11;                        /**< Velocity variance */
+    float       dt;                         /**< Sample period in s */
+    float       q00;                        /**< Process noise, altitude */
+    float       q01;                        /**< Process noise, cross term */
+    float       q11;                        /**< Process noise, velocity */
+    float       r;                          /**< Measurement noise in Pa^2, m^2 after the first sample */
+    float       base;                       /**< Altitude of the reference in m */
+    uint32_t    reference;                  /**< Raw pressure counts of the expansion point */
+
+}T_pressure_kalman;
+#endif
+
+#ifdef   __PRESSURE_MEDIAN__
+/**
+ * @brief Median filter state structure
+ *
+ * Samples below the median form a max heap below the centre index _PRESSURE_MEDIAN_WINDOW / 2,
+ * samples above it a min heap above the centre, the centre holds the median.
+ */
+typedef struct
+{
+    uint32_t    data[ _PRESSURE_MEDIAN_WINDOW ];    /**< Raw pressure counts, ring buffer */
+    uint8_t     pos[ _PRESSURE_MEDIAN_WINDOW ];     /**< Heap index of each ring slot */
+    uint8_t     heap[ _PRESSURE_MEDIAN_WINDOW ];    /**< Ring slot at each heap index */
+    uint8_t     next;                       /**< Ring slot of the next sample */
+    uint8_t     count;                      /**< Number of samples in the window */
+
+}T_pressure_median;
+#endif
+
+#ifdef   __PRESSURE_BATCH__
+/**
+ * @brief Batch consumer function type
+ *
+ * User supplied function which receives a contiguous span of samples, oldest first.
+ * The span is valid until the function returns.
+ */
+typedef void (*T_pressure_batchFp)(T_pressure_sample*, uint8_t);
 
+/**
+ * @brief Batch delivery statistics structure
+ */
+typedef struct
+{
+    uint32_t    samples;                    /**< Number of samples collected */
+    uint32_t    batches;                    /**< Number of consumer calls */
+    uint32_t    ageFlushes;                 /**< Consumer calls forced by the maximal age */
+    uint32_t    overruns;                   /**< Samples overwritten in the sensor before read ( P_OR ) */
+
+}T_pressure_batchStats;
+#endif
 
                                                                        /** @} */
 #ifdef __cplusplus
@@ -105,9 +668,36 @@ void pressure_spiDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P spiObj);
 void pressure_i2cDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P i2cObj, uint8_t slave);
 #endif
 #ifdef   __PRESSURE_DRV_UART__
+/**
+ * @brief UART streaming channel init function
+ *
+ * @param[in] gpioObj                   GPIO object
+ * @param[in] uartObj                   UART object
+ *
+ * Function map the UART used as the binary streaming channel and reset the stream.
+ * The sensor itself stays on the SPI or I2C driver initialized before.
+ */
 void pressure_uartDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P uartObj);
 #endif
 
+/**
+ * @brief Bus probe function
+ *
+ * @param[in]  gpioObj                  GPIO object of the mikroBUS socket
+ * @param[in]  i2cObj                   I2C object, 0 to skip the I2C probe
+ * @param[in]  spiObj                   SPI object, 0 to skip the SPI probe
+ * @param[out] list                     List of found devices, room for 3 entries
+ *
+ * @return
+ * Number of found devices
+ *
+ * Function try _PRESSURE_I2C_ADDRESS_0, _PRESSURE_I2C_ADDRESS_1 and the SPI CS line
+ * with a single _PRESSURE_DEVICE_ID_REG read each, without retries, and list every device
+ * which answers with 0xBB. The driver is left bound to the first found device,
+ * when no device answers the binding used before the probe is restored.
+ */
+uint8_t pressure_probe( T_PRESSURE_P gpioObj, T_PRESSURE_P i2cObj, T_PRESSURE_P spiObj, T_pressure_probeEntry *list );
+
 
 /** @defgroup PRESSURE_FUNC Driver Functions */                   /** @{ */
 
@@ -120,10 +710,14 @@ void pressure_uartDriverInit(T_PRESSURE_P gpioObj, T_PRESSURE_P uartObj);
  *
  * @param[in] writeData                 Byte of data to write
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function write the 8-bit data to the
  * target 8-bit register address of LPS331AP sensor on Pressure click board.
  */
-void pressure_writeData( uint8_t regAddress, uint8_t writeData );
+uint8_t pressure_writeData( uint8_t regAddress, uint8_t writeData );
 
 /**
  * @brief Generic read the byte of data function
@@ -135,9 +729,28 @@ void pressure_writeData( uint8_t regAddress, uint8_t writeData );
  *
  * Function read the 8-bit data from the
  * target 8-bit register address of LPS331AP sensor on Pressure click board.
+ *
+ * @note
+ * Returns 0 on bus error, use pressure_getLastError() or pressure_readRegister()
+ * to detect the failure.
  */
 uint8_t pressure_readData( uint8_t regAddress );
 
+/**
+ * @brief Generic read the byte of data with error status function
+ *
+ * @param[in]  regAddress               Register address
+ * @param[out] readData                 Pointer to the read data
+ *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
+ * Function read the 8-bit data from the
+ * target 8-bit register address of LPS331AP sensor on Pressure click board.
+ */
+uint8_t pressure_readRegister( uint8_t regAddress, uint8_t *readData );
+
 /**
  * @brief Device ID read function
  *
@@ -149,15 +762,51 @@ uint8_t pressure_readData( uint8_t regAddress );
  */
 uint8_t pressure_readID();
 
+/**
+ * @brief Set register field function
+ *
+ * @param[in] field                     _PRESSURE_FIELD_X field identifier
+ * @param[in] value                     Field value ( right aligned )
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_BUS   : bus error;
+ * - _PRESSURE_ERR_PARAM : unknown field or value wider than the field;
+ *
+ * Function set the register field by read-modify-write of the register
+ * described in the field descriptor table.
+ */
+uint8_t pressure_setField( uint8_t field, uint8_t value );
+
+/**
+ * @brief Get register field function
+ *
+ * @param[in] field                     _PRESSURE_FIELD_X field identifier
+ * @param[out] value                    Field value ( right aligned )
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_BUS   : bus error;
+ * - _PRESSURE_ERR_PARAM : unknown field;
+ *
+ * Function read the register described in the field descriptor table
+ * and extract the field value.
+ */
+uint8_t pressure_getField( uint8_t field, uint8_t *value );
+
 /**
  * @brief Set configuration function
  *
  * @param[in] configVal                 8-bit configuratio value
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function set configuration by write 8-bit configVal data to the
  * target 8-bit _PRESSURE_RES_CONFIG register of LPS331AP sensor on Pressure click board.
  */
-void pressure_setConfiguration( uint8_t configVal );
+uint8_t pressure_setConfiguration( uint8_t configVal );
 
 /**
  * @brief Get configuration function
@@ -173,18 +822,26 @@ uint8_t pressure_getConfiguration();
 /**
  * @brief Enable the device function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function enable the device by set bit7 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_enable();
+uint8_t pressure_enable();
 
 /**
  * @brief Disable the device function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function disable the device by clear bit7 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_powerDown();
+uint8_t pressure_powerDown();
 
 /**
  * @brief Set output data rate function
@@ -199,58 +856,86 @@ void pressure_powerDown();
  * - 6 : Pressure : 12.5 Hz ; Temperature : 12.5 Hz
  * - 7 : Pressure : 25 Hz   ; Temperature : 25 Hz
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function set output data rate by write output data rate value to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_setOutputDataRate( uint8_t outDataRate );
+uint8_t pressure_setOutputDataRate( uint8_t outDataRate );
 
 /**
  * @brief Enable interrupt function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function enable interrupt circuit by set bit3 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_enableInterruptCircuit();
+uint8_t pressure_enableInterruptCircuit();
 
 /**
  * @brief Disable interrupt function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function disable interrupt circuit by clear bit3 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_disableInterrupt();
+uint8_t pressure_disableInterrupt();
 
 /**
  * @brief Enable block data update function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function enable interrupt circuit by set bit2 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_blockDataUpdate();
+uint8_t pressure_blockDataUpdate();
 
 /**
  * @brief Disable block data - continuous update function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function disable block data - continuous update circuit by clear bit2 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_unblockDataUpdate();
+uint8_t pressure_unblockDataUpdate();
 
 /**
  * @brief Delta pressure enable function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function enable delta pressure by set bit1 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_enableDeltaPressure();
+uint8_t pressure_enableDeltaPressure();
 
 /**
  * @brief Delta pressure disable function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function disable delta pressure by clear bit1 to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_disableDeltaPressure();
+uint8_t pressure_disableDeltaPressure();
 
 /**
  * @brief SPI serial interface mode function
@@ -259,10 +944,14 @@ void pressure_disableDeltaPressure();
  * - 3 : 3-wire interface
  * - 3 : 4-wire interface;
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function SPI serial interface mode by write wireInterface value to the
  * target 8-bit _PRESSURE_CTRL_REG1 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_spiSerialInterfaceMode( uint8_t wireInterface );
+uint8_t pressure_spiSerialInterfaceMode( uint8_t wireInterface );
 
 /**
  * @brief Reboot memory content mode function
@@ -271,18 +960,26 @@ void pressure_spiSerialInterfaceMode( uint8_t wireInterface );
  * - 0 : normal mode;
  * - 3 : reboot memory content;
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function reboot memory content mode by write rmMode value to the
  * target 8-bit _PRESSURE_CTRL_REG2 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_rebootMemoryMode( uint8_t rmMode );
+uint8_t pressure_rebootMemoryMode( uint8_t rmMode );
 
 /**
  * @brief Software reset function
  *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
  * Function software reset by set bit2 to the
  * target 8-bit _PRESSURE_CTRL_REG2 register of LPS331AP sensor on Pressure click board.
  */
-void pressure_softReset();
+uint8_t pressure_softReset();
 
 /**
  * @brief Set interrupt configuration function
@@ -299,10 +996,21 @@ void pressure_softReset();
  *            - 0 : disable interrupt request;
  *            - 1 : enable interrupt request on measured differential pressure value higher than preset threshold
  *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_BUS   : bus error;
+ * - _PRESSURE_ERR_PARAM : reserved bits set;
+ *
  * Function set interrupt configuration by write intConfigVal value to the
  * target 8-bit _PRESSURE_INT_CFG_REG register of LPS331AP sensor on Pressure click board.
+ *
+ * @note
+ * intConfigVal replaces the register contents. Earlier versions ORed it into the
+ * previous value ( and wrote the result to _PRESSURE_CTRL_REG2 ), so bits could only
+ * be set. To keep bits which are already enabled, read them with
+ * pressure_getInterruptConfig() and pass the combined value.
  */
-void pressure_setInterruptConfig( uint8_t intConfigVal );
+uint8_t pressure_setInterruptConfig( uint8_t intConfigVal );
 
 /**
  * @brief Get interrupt configuration function
@@ -328,6 +1036,35 @@ uint8_t pressure_getInterruptConfig();
  */
 uint8_t pressure_defaultCofig();
 
+/**
+ * @brief Get default configuration function
+ *
+ * @param[out] cfg                      Pointer to the configuration structure
+ *
+ * Function fill the configuration structure with the register values
+ * written by pressure_defaultCofig().
+ */
+void pressure_getDefaultConfig( T_pressure_config *cfg );
+
+/**
+ * @brief Warm start function
+ *
+ * @param[in] cfg                       Pointer to the desired configuration
+ *
+ * @return
+ * - _PRESSURE_OK         : success;
+ * - _PRESSURE_ERR_BUS    : bus error;
+ * - _PRESSURE_ERR_VERIFY : wrong device ID or write verification failed;
+ *
+ * Function read device ID and _PRESSURE_RES_CONFIG in one burst and
+ * _PRESSURE_CTRL_REG1 to _PRESSURE_THS_P_MSB_REG in another, and write only the registers
+ * which differ from the desired configuration. When any register differs an active device
+ * is powered down first and _PRESSURE_CTRL_REG1 is written last.
+ * After an MCU reset with the sensor still configured no write is done at all.
+ * Written registers are read back only when __PRESSURE_VERIFY_WRITES__ is selected.
+ */
+uint8_t pressure_warmStart( T_pressure_config *cfg );
+
 /**
  * @brief Get pressure function
  *
@@ -338,6 +1075,13 @@ uint8_t pressure_defaultCofig();
  * target 8-bit _PRESSURE_PRESS_OUT_MSB, _PRESSURE_PRESS_OUT_LSB and _PRESSURE_PRESS_POUT_XLB_REH register
  * of LPS331AP sensor on Pressure click board
  * and convert that data to pressure in mbar.
+ *
+ * @note
+ * Once a calibration is set ( __PRESSURE_CALIBRATION__ ) the temperature registers are read
+ * in the same burst and the result is pressure_calibratedPressure().
+ *
+ * With __PRESSURE_IDLE__ selected the first read after an idle power-down blocks until
+ * the first conversion, up to 1.1 s, see pressure_idleService().
  */
 float pressure_getPressure();
 
@@ -351,6 +1095,10 @@ float pressure_getPressure();
  * target 8-bit _PRESSURE_TEMP_OUT_MSB and _PRESSURE_TEMP_OUT_LSB register
  * of LPS331AP sensor on Pressure click board
  * and convert that data to temperature in degrees Celsius.
+ *
+ * @note
+ * With __PRESSURE_IDLE__ selected the first read after an idle power-down blocks until
+ * the first conversion, up to 1.1 s, see pressure_idleService().
  */
 float pressure_getTemperature();
 
@@ -366,7 +1114,1148 @@ float pressure_getTemperature();
  */
 uint8_t pressure_getInterruptState();
 
+/**
+ * @brief Generic burst read function
+ *
+ * @param[in]  regAddress               First register address
+ * @param[out] rBuffer                  Pointer to the buffer for read data
+ * @param[in]  nBytes                   Number of bytes to read
+ *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
+ * Function read nBytes consecutive registers starting from the
+ * target 8-bit register address of LPS331AP sensor on Pressure click board,
+ * using register address auto increment, in a single bus transaction.
+ */
+uint8_t pressure_readBytes( uint8_t regAddress, uint8_t *rBuffer, uint8_t nBytes );
+
+/**
+ * @brief Get last error function
+ *
+ * @return
+ * - _PRESSURE_OK      : no error since the last call;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
+ * Function get and clear the last error of the driver calls which do not return status
+ * ( pressure_readData(), pressure_getPressure(), pressure_getTemperature() ... ).
+ */
+uint8_t pressure_getLastError();
+
+/**
+ * @brief Set retry budget function
+ *
+ * @param[in] nRetries                  Number of retries of a failed bus transaction ( default 2 )
+ *
+ * Function set how many times a failed bus transaction is repeated before the error is reported.
+ * When __PRESSURE_BUS_RECOVERY__ is selected the bus recovery is executed before every retry.
+ */
+void pressure_setRetryBudget( uint8_t nRetries );
+
+/**
+ * @brief Get bus statistics function
+ *
+ * @param[out] stats                    Pointer to the bus statistics structure
+ *
+ * Function get the transaction, error, retry and recovery counters
+ * and time spent on failing transactions ( in ticks of the tick source ).
+ */
+void pressure_getBusStats( T_pressure_busStats *stats );
+
+/**
+ * @brief Reset bus statistics function
+ *
+ * Function clear the bus statistics.
+ */
+void pressure_resetBusStats();
+
+#ifdef   __PRESSURE_BUS_RECOVERY__
+/**
+ * @brief Bus recovery function
+ *
+ * @return
+ * - _PRESSURE_OK      : SDA line released;
+ * - _PRESSURE_ERR_BUS : SDA line still held low;
+ *
+ * Function clock up to 9 pulses on SCL pin until the slave holding SDA low releases the line,
+ * then generate STOP condition. Recovery is counted only when pulses were needed.
+ *
+ * @note
+ * SCL and SDA pins must be accessible as GPIO through the gpioObj passed to the driver init.
+ */
+uint8_t pressure_busRecovery();
+#endif
+
+#ifdef   __PRESSURE_BUS_ARBITER__
+/** @defgroup PRESSURE_ARB Shared Bus Arbitration */              /** @{ */
+
+/**
+ * @brief Set bus arbiter function
+ *
+ * @param[in] arbiter                   Pointer to the arbiter hooks, 0 to disable arbitration
+ *
+ * Function set the hooks used to lock the shared bus for every whole transaction
+ * ( START to STOP, or CS low to CS high ) including its retries, and for the bus recovery.
+ * When tryLock fails the inherit hook is called before the blocking lock, so the RTOS can
+ * raise the priority of the current owner. The restore hook is called after every release.
+ *
+ * The lock is held across read-modify-write sequences : pressure_setField() and the
+ * functions built on it ( pressure_enable(), pressure_powerDown() ... ), pressure_setConfiguration(),
+ * pressure_warmStart(), pressure_setPowerProfile() and pressure_probe(). Bus statistics and
+ * the last error are updated and read only while the lock is held. Other multi call sequences,
+ * e.g. pressure_defaultCofig(), are not atomic.
+ *
+ * @note
+ * Hooks are copied, the structure may be released after the call. The lock is not taken
+ * recursively, hooks must not call driver functions.
+ */
+void pressure_setArbiter( T_pressure_arbiter *arbiter );
+
+/**
+ * @brief Get bus arbitration statistics function
+ *
+ * @param[out] stats                    Pointer to the arbitration statistics structure
+ *
+ * Function get the lock acquisition and contention counters and time spent
+ * waiting for the bus ( in ticks of the tick source ).
+ */
+void pressure_getArbStats( T_pressure_arbStats *stats );
+
+/**
+ * @brief Reset bus arbitration statistics function
+ *
+ * Function clear the bus arbitration statistics.
+ */
+void pressure_resetArbStats();
+
+                                                                       /** @} */
+#endif
+
+/**
+ * @brief Set tick source function
+ *
+ * @param[in] tickFp                    Pointer to the user tick function, 0 to disable timestamping
+ *
+ * Function set the monotonic tick source used for sample timestamping.
+ * Tick unit is defined by the user function ( e.g. microseconds or timer counts ).
+ */
+void pressure_setTickSource( T_pressure_tickFp tickFp );
+
+/**
+ * @brief Set timestamp mode function
+ *
+ * @param[in] tsMode
+ * - _PRESSURE_TIMESTAMP_AT_READ : timestamp is taken when the sample read is completed;
+ * - _PRESSURE_TIMESTAMP_AT_INT  : timestamp is taken by pressure_captureTimestamp() at INT edge;
+ *
+ * Function set the moment at which the sample timestamp is captured.
+ */
+void pressure_setTimestampMode( uint8_t tsMode );
+
+/**
+ * @brief Capture timestamp function
+ *
+ * Function capture the current tick as the timestamp of the next sample.
+ *
+ * @note
+ * Should be called from the INT pin interrupt routine ( data ready edge )
+ * when _PRESSURE_TIMESTAMP_AT_INT mode is selected.
+ */
+void pressure_captureTimestamp();
+
+/**
+ * @brief Read sample function
+ *
+ * @param[out] sample                   Pointer to the sample structure
+ *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
+ * Function read raw pressure and temperature data from the
+ * target 8-bit _PRESSURE_PRESS_POUT_XLB_REH to _PRESSURE_TEMP_OUT_MSB registers
+ * of LPS331AP sensor on Pressure click board in one burst, attach the timestamp
+ * and update the sample interval jitter statistics.
+ *
+ * @note
+ * Once a calibration is set ( __PRESSURE_CALIBRATION__ ) sample pressure holds
+ * calibrated counts ( offset, tempco and gain applied, clamped to 24 bits ).
+ *
+ * With __PRESSURE_IDLE__ selected the first read after an idle power-down blocks until
+ * the first conversion, up to 1.1 s, see pressure_idleService().
+ */
+uint8_t pressure_readSample( T_pressure_sample *sample );
+
+/**
+ * @brief Get jitter statistics function
+ *
+ * @param[out] stats                    Pointer to the jitter statistics structure
+ *
+ * Function get min/max/mean sample interval and interval variance
+ * measured by pressure_readSample() since the last reset.
+ */
+void pressure_getJitterStats( T_pressure_jitterStats *stats );
+
+/**
+ * @brief Reset jitter statistics function
+ *
+ * Function clear the sample interval jitter statistics.
+ */
+void pressure_resetJitterStats();
+
+#ifdef   __PRESSURE_LATENCY__
+/** @defgroup PRESSURE_LATENCY Latency Histogram */               /** @{ */
+
+/**
+ * @brief Poll data ready function
+ *
+ * @return
+ * - 0 : no new data ready edge;
+ * - 1 : data ready edge detected;
+ *
+ * Function poll the INT pin and capture the data ready tick on its rising edge.
+ */
+uint8_t pressure_pollDataReady();
+
+/**
+ * @brief Sample consumed function
+ *
+ * @param[in] sample                    Pointer to the sample taken by the consumer
+ *
+ * Function mark the moment the consumer dequeues the sample
+ * and accumulate read-to-consume and ready-to-consume latency.
+ */
+void pressure_sampleConsumed( T_pressure_sample *sample );
+
+/**
+ * @brief Get latency histogram image function
+ *
+ * @param[out] buffer                   Buffer of at least _PRESSURE_LATENCY_IMAGE_SIZE bytes
+ *
+ * @return
+ * Number of bytes written
+ *
+ * Function dump ready-to-read, read-to-consume and ready-to-consume histograms,
+ * _PRESSURE_LATENCY_BUCKETS 16-bit little endian counters each, into the buffer.
+ * Bucket n counts latencies in range [ 2^(n-1), 2^n ) ticks, bucket 0 counts zero latency
+ * and the last bucket also collects all longer latencies.
+ */
+uint8_t pressure_getLatencyImage( uint8_t *buffer );
+
+/**
+ * @brief Print latency histogram function
+ *
+ * @param[in] putsFp                    Pointer to the text output function
+ *
+ * Function print all non-empty histogram buckets as text, one line per bucket.
+ */
+void pressure_printLatency( T_pressure_putsFp putsFp );
+
+/**
+ * @brief Reset latency histogram function
+ *
+ * Function clear all latency histograms.
+ */
+void pressure_resetLatency();
+
+                                                                       /** @} */
+#endif
+
+
+
+#ifdef   __PRESSURE_SCHEDULER__
+/** @defgroup PRESSURE_SCHED Cooperative Scheduler */            /** @{ */
+
+/**
+ * @brief Add periodic task function
+ *
+ * @param[in] taskFp                    Pointer to the task function
+ * @param[in] period                    Task period in ticks
+ * @param[in] deadline                  Relative deadline in ticks ( 0 : equal to period )
+ *
+ * @return
+ * Task id or _PRESSURE_SCHED_NO_TASK if the task table is full
+ *
+ * Function register a periodic task, first release is one period from now.
+ */
+uint8_t pressure_schedAddTask( T_pressure_taskFp taskFp, uint32_t period, uint32_t deadline );
+
+/**
+ * @brief Add data ready task function
+ *
+ * @param[in] taskFp                    Pointer to the task function
+ * @param[in] deadline                  Relative deadline in ticks
+ *
+ * @return
+ * Task id or _PRESSURE_SCHED_NO_TASK if the task table is full
+ *
+ * Function register a task which is released every time the INT pin
+ * of Pressure click board signals new data ( INT pin must be configured as data ready ).
+ */
+uint8_t pressure_schedAddDataReadyTask( T_pressure_taskFp taskFp, uint32_t deadline );
+
+/**
+ * @brief Set sleep hook function
+ *
+ * @param[in] sleepFp                   Pointer to the sleep hook, 0 to busy wait
+ *
+ * Function set the hook which receives the idle time until the next task release,
+ * or _PRESSURE_SCHED_UNTIL_INT when no periodic task is registered.
+ * The hook must return earlier when the INT pin interrupt occurs
+ * if data ready tasks are registered.
+ */
+void pressure_schedSetSleep( T_pressure_sleepFp sleepFp );
+
+/**
+ * @brief Scheduler run function
+ *
+ * Function run one scheduling step : the released task with the earliest
+ * absolute deadline is executed, when no task is released the idle time
+ * until the next release is passed to the sleep hook.
+ *
+ * @note
+ * Should be called from the main loop. Requires tick source set by pressure_setTickSource().
+ */
+void pressure_schedRun();
+
+/**
+ * @brief Get ODR period function
+ *
+ * @param[in] outDataRate               Output data rate code as for pressure_setOutputDataRate()
+ * @param[in] ticksPerSecond            Tick source frequency
+ *
+ * @return
+ * Pressure output data period in ticks, 0 for one shot mode
+ *
+ * Function calculate sampling task period matching the sensor pressure output data rate.
+ */
+uint32_t pressure_schedOdrPeriod( uint8_t outDataRate, uint32_t ticksPerSecond );
+
+/**
+ * @brief Get task statistics function
+ *
+ * @param[in]  taskId                   Task id
+ * @param[out] stats                    Pointer to the task statistics structure
+ *
+ * Function get execution count, missed deadlines and maximal lateness of the task.
+ */
+void pressure_schedGetStats( uint8_t taskId, T_pressure_taskStats *stats );
+
+/**
+ * @brief Get idle ticks function
+ *
+ * @return
+ * Total number of ticks passed to the sleep hook
+ *
+ * Function get the time the scheduler spent idle.
+ */
+uint32_t pressure_schedIdleTicks();
+
+                                                                       /** @} */
+#endif
+
+/**
+ * @brief Set analog front end control function
+ *
+ * @param[in] ampCtrl                   8-bit analog front end control value ( bit0 : SELMAIN )
+ *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
+ * Function write ampCtrl value to the
+ * target 8-bit _PRESSURE_AMP_CTRL register of LPS331AP sensor on Pressure click board.
+ */
+uint8_t pressure_setAmpControl( uint8_t ampCtrl );
+
+/**
+ * @brief Set power profile function
+ *
+ * @param[in] profile
+ * - _PRESSURE_PROFILE_ULTRA_LOW_POWER : 1 Hz, no averaging;
+ * - _PRESSURE_PROFILE_BALANCED        : 7 Hz pressure / 1 Hz temperature, moderate averaging;
+ * - _PRESSURE_PROFILE_HIGH_RESOLUTION : 1 Hz, maximal averaging;
+ * - _PRESSURE_PROFILE_HIGH_RATE       : 25 Hz, low averaging;
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_BUS   : bus error;
+ * - _PRESSURE_ERR_PARAM : unknown profile, the device is not touched;
+ *
+ * Function apply output data rate, averaging and analog front end setting of the profile.
+ * Only the registers which differ from the previously applied profile are written.
+ * When averaging or front end setting changes, the device is held in power down
+ * until the new setting is complete, switching between profiles which differ
+ * only in output data rate takes a single _PRESSURE_CTRL_REG1 write.
+ */
+uint8_t pressure_setPowerProfile( uint8_t profile );
+
+/**
+ * @brief Get power profile info function
+ *
+ * @param[in]  profile                  Power profile
+ * @param[out] info                     Pointer to the profile info structure
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : unknown profile, info is not written;
+ *
+ * Function get register settings, estimated supply current and pressure noise of the profile.
+ */
+uint8_t pressure_getPowerProfileInfo( uint8_t profile, T_pressure_profileInfo *info );
+
+#ifdef   __PRESSURE_TRACE__
+/** @defgroup PRESSURE_TRACE Register Traffic Capture */          /** @{ */
+
+/**
+ * @brief Set trace sink function
+ *
+ * @param[in] traceFp                   Pointer to the trace sink, 0 to stop the capture
+ *
+ * Function start capture of every bus transaction attempt into the binary trace.
+ * Each record is passed to the sink and has following format :
+ * - byte 0     : bit7 - read, bit6 - SPI, bit5 - bus error, bit4:0 - number of data bytes;
+ * - byte 1     : register address byte as sent on the bus;
+ * - byte 2..5  : timestamp ( tick source ), little endian;
+ * - byte 6..   : written or read data bytes;
+ *
+ * INT pin level changes seen by the driver are recorded as header 0x1F
+ * ( writes never carry 31 data bytes ), byte 1 - new level, no data bytes.
+ */
+void pressure_setTraceSink( T_pressure_traceFp traceFp );
+
+                                                                       /** @} */
+#endif
+#ifdef   __PRESSURE_HAL_REPLAY__
+/** @defgroup PRESSURE_REPLAY Trace Replay */                     /** @{ */
+
+/**
+ * @brief Replay init function
+ *
+ * @param[in] trace                     Pointer to the captured trace
+ * @param[in] nBytes                    Trace size in bytes
+ *
+ * Function load the trace into the replay HAL, following driver bus transactions
+ * are served from the trace records instead of the bus.
+ */
+void pressure_replayInit( const uint8_t *trace, uint32_t nBytes );
+
+/**
+ * @brief Replay tick function
+ *
+ * @return
+ * Timestamp of the last replayed record
+ *
+ * Function can be used as the driver tick source so the replayed samples
+ * keep their original timestamps.
+ */
+uint32_t pressure_replayTick();
+
+/**
+ * @brief Replay done function
+ *
+ * @return
+ * - 0 : trace records left;
+ * - 1 : whole trace replayed;
+ */
+uint8_t pressure_replayDone();
+
+/**
+ * @brief Replay mismatches function
+ *
+ * @return
+ * Number of driver transactions or INT pin reads which differ from the trace
+ *
+ * Function report divergence of the driver under test from the captured run :
+ * different register address, direction, interface or written data,
+ * transactions past the end of the trace and unread INT pin changes.
+ */
+uint32_t pressure_replayMismatches();
+
+                                                                       /** @} */
+#endif
+
+/** @defgroup PRESSURE_CONV Conversion Kernels */                 /** @{ */
+
+/**
+ * @brief Raw pressure to mbar function
+ *
+ * @param[in] rawPressure               Raw 24-bit pressure counts
+ *
+ * @return
+ * float pressure in mbar
+ */
+float pressure_rawToPressure( uint32_t rawPressure );
+
+/**
+ * @brief Raw temperature to degrees Celsius function
+ *
+ * @param[in] rawTemperature            Raw 16-bit temperature counts
+ *
+ * @return
+ * float temperature in degrees Celsius
+ */
+float pressure_rawToTemperature( int16_t rawTemperature );
 
+/**
+ * @brief Raw pressure to Pascal function
+ *
+ * @param[in] rawPressure               Raw 24-bit pressure counts
+ *
+ * @return
+ * Pressure in Pa ( 0.01 mbar ), rounded to nearest
+ *
+ * Integer only conversion, the result is the exact rounding of rawPressure * 100 / 4096.
+ */
+uint32_t pressure_rawToPascal( uint32_t rawPressure );
+
+/**
+ * @brief Raw temperature to centi degrees Celsius function
+ *
+ * @param[in] rawTemperature            Raw 16-bit temperature counts
+ *
+ * @return
+ * Temperature in 0.01 degrees Celsius, rounded to nearest
+ *
+ * Integer only conversion, the result is the exact rounding of ( rawTemperature / 480 + 42.5 ) * 100.
+ */
+int16_t pressure_rawToCentiCelsius( int16_t rawTemperature );
+
+/**
+ * @brief Block conversion function
+ *
+ * @param[in]  raw                      Raw register images, 5 bytes ( _PRESSURE_PRESS_POUT_XLB_REH to _PRESSURE_TEMP_OUT_MSB ) per sample
+ * @param[in]  nSamples                 Number of samples
+ * @param[out] outP                     Pressure output in mbar ( nSamples floats ), 0 to skip
+ * @param[out] outT                     Temperature output in degrees Celsius ( nSamples floats ), 0 to skip
+ *
+ * Function unpack and convert a block of buffered raw samples ( as read by pressure_readBytes()
+ * from _PRESSURE_PRESS_POUT_XLB_REH ). Results are identical to pressure_rawToPressure()
+ * and pressure_rawToTemperature().
+ *
+ * @note
+ * Builds with AVX2 ( 8 samples ) or SSSE3 ( 4 samples ) use vector unpacking,
+ * other targets ( MCUs included ) the scalar loop.
+ */
+void pressure_convertBlock( const uint8_t *raw, size_t nSamples, float *outP, float *outT );
+
+                                                                       /** @} */
+
+#ifdef   __PRESSURE_STATS__
+/** @defgroup PRESSURE_STATS Streaming Statistics */              /** @{ */
+
+/**
+ * @brief Statistics reset function
+ *
+ * @param[out] stats                    Pointer to the accumulator
+ *
+ * Function clear the accumulator, it should be called at the start of every window.
+ */
+void pressure_statsReset( T_pressure_stats *stats );
+
+/**
+ * @brief Statistics update function
+ *
+ * @param[in,out] stats                 Pointer to the accumulator
+ * @param[in]     raw                   Raw pressure counts or raw temperature counts
+ *
+ * Function add one raw sample to the accumulator, integer arithmetic only.
+ * Sums are exact while count times the largest squared deviation from the first
+ * sample stays below 2^64 ( e.g. 10^8 samples spanning 100 mbar ).
+ */
+void pressure_statsUpdate( T_pressure_stats *stats, int32_t raw );
+
+/**
+ * @brief Statistics merge function
+ *
+ * @param[in,out] dst                   Pointer to the destination accumulator
+ * @param[in]     src                   Pointer to the accumulator merged into dst
+ *
+ * Function combine two accumulators of the same channel, e.g. per minute windows into an hour.
+ */
+void pressure_statsMerge( T_pressure_stats *dst, T_pressure_stats *src );
+
+/**
+ * @brief Pressure statistics readout function
+ *
+ * @param[in]  stats                    Pointer to the pressure accumulator
+ * @param[out] result                   Pointer to the result in mbar
+ */
+void pressure_statsPressure( T_pressure_stats *stats, T_pressure_statsResult *result );
+
+/**
+ * @brief Temperature statistics readout function
+ *
+ * @param[in]  stats                    Pointer to the temperature accumulator
+ * @param[out] result                   Pointer to the result in degrees Celsius
+ */
+void pressure_statsTemperature( T_pressure_stats *stats, T_pressure_statsResult *result );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_DECIMATOR__
+/** @defgroup PRESSURE_DECIM Decimation */                        /** @{ */
+
+/**
+ * @brief Decimator init function
+ *
+ * @param[out] dec                      Pointer to the decimator state
+ * @param[in]  ratio                    Decimation ratio 2..64
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : ratio out of range;
+ *
+ * Function initialise second order CIC decimator followed by
+ * 3-tap droop compensating FIR [ -1 10 -1 ] / 8 at the output rate.
+ */
+uint8_t pressure_decimatorInit( T_pressure_decimator *dec, uint8_t ratio );
+
+/**
+ * @brief Decimator process function
+ *
+ * @param[in,out] dec                   Pointer to the decimator state
+ * @param[in]     input                 Raw 24-bit pressure counts at sensor ODR
+ * @param[in]     nInput                Number of input samples
+ * @param[out]    output                Decimated raw pressure counts, at most nInput / ratio + 1 values
+ *
+ * @return
+ * Number of output samples
+ *
+ * Function filter and decimate a block of raw samples.
+ *
+ * @note
+ * Filter works on deviations from the first sample. When the input moves further than
+ * 2^30 / ratio^2 counts ( 64 mbar at ratio 64 ) from it, the filter restarts from the current sample.
+ * Outputs are suppressed until the CIC and FIR delay lines hold only samples since the
+ * ( re )start, 3 output periods, plus the partial block when the restart falls inside one.
+ * The output grid is kept across restarts and every suppressed output slot is counted
+ * in dropped, so outputs + dropped advance by one per ratio input samples.
+ */
+uint16_t pressure_decimatorProcess( T_pressure_decimator *dec, uint32_t *input, uint16_t nInput, uint32_t *output );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_CALIBRATION__
+/** @defgroup PRESSURE_CAL Calibration */                         /** @{ */
+
+/**
+ * @brief Set calibration storage function
+ *
+ * @param[in] loadFp                    Pointer to the load function
+ * @param[in] storeFp                   Pointer to the store function, 0 to not persist
+ *
+ * Function set user functions which persist the device calibration record.
+ */
+void pressure_setCalibrationStorage( T_pressure_calFp loadFp, T_pressure_calFp storeFp );
+
+/**
+ * @brief Load calibration function
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : no load function or load failed;
+ *
+ * Function load the calibration record through the load function and apply it.
+ */
+uint8_t pressure_loadCalibration();
+
+/**
+ * @brief Set calibration function
+ *
+ * @param[in] cal                       Pointer to the calibration record
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : gain out of range or store failed;
+ *
+ * Function apply the calibration record and store it through the store function.
+ */
+uint8_t pressure_setCalibration( T_pressure_calibration *cal );
+
+/**
+ * @brief Get calibration function
+ *
+ * @param[out] cal                      Pointer to the calibration record
+ */
+void pressure_getCalibration( T_pressure_calibration *cal );
+
+/**
+ * @brief Calibrated pressure in mbar function
+ *
+ * @param[in] rawPressure               Raw 24-bit pressure counts
+ * @param[in] rawTemperature            Raw 16-bit temperature counts
+ *
+ * @return
+ * float corrected pressure in mbar
+ *
+ * Function apply offset and temperature correction in integer counts,
+ * the gain is folded into the single float scaling of the conversion.
+ */
+float pressure_calibratedPressure( uint32_t rawPressure, int16_t rawTemperature );
+
+/**
+ * @brief Calibrated pressure in Pascal function
+ *
+ * @param[in] rawPressure               Raw 24-bit pressure counts
+ * @param[in] rawTemperature            Raw 16-bit temperature counts
+ *
+ * @return
+ * Corrected pressure in Pa, rounded to nearest
+ *
+ * Integer only conversion with the gain folded into the fixed point scale factor,
+ * with unity calibration the result is equal to pressure_rawToPascal().
+ */
+uint32_t pressure_calibratedPascal( uint32_t rawPressure, int16_t rawTemperature );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_TXN_QUEUE__
+/** @defgroup PRESSURE_QUEUE Transaction Queue */                 /** @{ */
+
+/**
+ * @brief Set queue merge period function
+ *
+ * @param[in] periodTicks               Conversion period in ticks, 0 to merge only requests pending together
+ *
+ * Function set how long a completed read is reused for later requests of the same
+ * or enclosed register range. Set it to the output data period, e.g. as returned
+ * by pressure_schedOdrPeriod(). Requires the tick source.
+ */
+void pressure_queueSetPeriod( uint32_t periodTicks );
+
+/**
+ * @brief Queue read function
+ *
+ * @param[in] regAddress                First register address
+ * @param[out] rBuffer                  Destination buffer, valid until completion
+ * @param[in] nBytes                    Number of registers ( 1 to _PRESSURE_QUEUE_MAX_BYTES )
+ * @param[in] deadline                  Deadline tick
+ * @param[in] doneFp                    Completion function, may be 0
+ *
+ * @return
+ * Request slot, _PRESSURE_QUEUE_NO_SLOT when the queue is full or nBytes is out of range
+ *
+ * Function enqueue the burst read request. Requests are served by pressure_queueService().
+ * The queue is updated with the bus arbiter lock held ( __PRESSURE_BUS_ARBITER__ ),
+ * without an arbiter requests must be queued from a single context.
+ */
+uint8_t pressure_queueRead( uint8_t regAddress, uint8_t *rBuffer, uint8_t nBytes, uint32_t deadline, T_pressure_doneFp doneFp );
+
+/**
+ * @brief Queue pending function
+ *
+ * @param[in] slot                      Request slot
+ *
+ * @return
+ * - 0 : request completed;
+ * - 1 : request waits for service;
+ */
+uint8_t pressure_queuePending( uint8_t slot );
+
+/**
+ * @brief Queue service function
+ *
+ * @return
+ * Number of bus reads done
+ *
+ * Function serve pending requests in earliest deadline order. Each request is served
+ * from a read of the same or enclosing register range done within the merge period,
+ * otherwise it is read from the device. The burst is widened to every pending request
+ * overlapping or adjoining it ( up to _PRESSURE_QUEUE_MAX_BYTES ) and all requests enclosed
+ * by the read receive the same data and status.
+ *
+ * @note
+ * The bus lock is held for the whole service, completion functions are called after it
+ * is released. pressure_writeData() and every other register write drops cached reads
+ * of the written register.
+ *
+ * With __PRESSURE_IDLE__ selected the first read after an idle power-down blocks until
+ * the first conversion, up to 1.1 s, see pressure_idleService().
+ */
+uint8_t pressure_queueService();
+
+/**
+ * @brief Get queue statistics function
+ *
+ * @param[out] stats                    Pointer to the queue statistics structure
+ */
+void pressure_queueGetStats( T_pressure_queueStats *stats );
+
+/**
+ * @brief Reset queue statistics function
+ *
+ * Function clear the queue statistics and drop cached reads.
+ */
+void pressure_queueResetStats();
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_DRV_UART__
+/** @defgroup PRESSURE_STREAM UART Binary Streaming */            /** @{ */
+
+/**
+ * @brief Stream reset function
+ *
+ * Function empty the TX ring, restart sequence numbering and clear the statistics.
+ */
+void pressure_streamReset();
+
+/**
+ * @brief Stream sample function
+ *
+ * @return
+ * - _PRESSURE_OK      : frame queued or dropped on full ring;
+ * - _PRESSURE_ERR_BUS : bus error, nothing queued;
+ *
+ * Function burst read the raw pressure and temperature registers and queue them
+ * unconverted as one frame :
+ * - _PRESSURE_FRAME_SYNC, type, sequence, payload length, payload, CRC-8;
+ *
+ * CRC-8 ( polynomial 0x07, init 0x00 ) covers type, sequence, length and payload.
+ * A frame dropped on full ring still consumes its sequence number, so the host
+ * detects the loss as a sequence gap.
+ *
+ * @note
+ * With __PRESSURE_IDLE__ selected the first read after an idle power-down blocks until
+ * the first conversion, up to 1.1 s, see pressure_idleService().
+ */
+uint8_t pressure_streamSample();
+
+/**
+ * @brief Stream TX interrupt function
+ *
+ * @return
+ * - 0 : TX ring empty, nothing written;
+ * - 1 : one byte written;
+ *
+ * Function write the next queued byte by hal_uartWrite. Call it from the UART
+ * transmit interrupt, and once to start the transmission when the transmitter is idle.
+ */
+uint8_t pressure_streamTxIsr();
+
+/**
+ * @brief Stream TX span function
+ *
+ * @param[out] span                     Pointer to the first queued byte
+ *
+ * @return
+ * Number of contiguous queued bytes starting at span
+ *
+ * Function give the contiguous part of the TX ring for the DMA transfer,
+ * release it with pressure_streamTxAdvance() when the transfer is done.
+ */
+uint8_t pressure_streamTxSpan( uint8_t **span );
+
+/**
+ * @brief Stream TX advance function
+ *
+ * @param[in] nBytes                    Number of transmitted bytes
+ */
+void pressure_streamTxAdvance( uint8_t nBytes );
+
+/**
+ * @brief Stream RX service function
+ *
+ * @return
+ * Number of received commands
+ *
+ * Function parse received bytes in the same frame format and execute :
+ * - _PRESSURE_CMD_SET_ODR     : payload - output data rate code;
+ * - _PRESSURE_CMD_SET_PROFILE : payload - _PRESSURE_PROFILE_X;
+ *
+ * Each command is answered with _PRESSURE_FRAME_ACK frame carrying the command type and status.
+ */
+uint8_t pressure_streamRxService();
+
+/**
+ * @brief Get stream statistics function
+ *
+ * @param[out] stats                    Pointer to the stream statistics structure
+ */
+void pressure_streamGetStats( T_pressure_streamStats *stats );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_IDLE__
+/** @defgroup PRESSURE_IDLE Idle Power Management */              /** @{ */
+
+/**
+ * @brief Set idle timeout function
+ *
+ * @param[in] idleTicks                 Ticks without consumer read before power-down, 0 to disable
+ *
+ * Function set the idle period of the idle manager. Requires the tick source.
+ */
+void pressure_idleSetTimeout( uint32_t idleTicks );
+
+/**
+ * @brief Idle service function
+ *
+ * @return
+ * - _PRESSURE_OK      : success;
+ * - _PRESSURE_ERR_BUS : bus error;
+ *
+ * Function power the device down when no consumer read arrived within the idle timeout.
+ * Call it periodically, with __PRESSURE_SCHEDULER__ selected it is also called by
+ * pressure_schedRun() before the idle sleep.
+ *
+ * @note
+ * Consumer reads ( pressure_getPressure, pressure_getTemperature, pressure_readSample and
+ * the queue and stream reads when selected ) wake the device transparently :
+ * the device is enabled and the read waits for the first conversion, at most one pressure
+ * output period. With ODR codes 2 to 4 ( temperature at 1 Hz ) only new pressure data is
+ * awaited.
+ *
+ * The wait polls _PRESSURE_STATUS_REG every millisecond ( Delay_1ms ), so the first read
+ * after a power-down blocks the caller for up to :
+ * - ODR 0 ( one shot ) and 1 : 1100 ms;
+ * - ODR 2 and 5 : 158 ms;
+ * - ODR 3 and 6 : 88 ms;
+ * - ODR 4 and 7 : 44 ms;
+ * plus the bus time of every poll. Use an idle timeout longer than the consumer read
+ * period, or disable the manager, where this blocking is not acceptable.
+ */
+uint8_t pressure_idleService();
+
+/**
+ * @brief Get idle statistics function
+ *
+ * @param[out] stats                    Pointer to the idle statistics structure
+ *
+ * Function get power-down and wake counters, wake latency and residency in ticks,
+ * residency includes the current state up to now.
+ */
+void pressure_idleGetStats( T_pressure_idleStats *stats );
+
+/**
+ * @brief Reset idle statistics function
+ */
+void pressure_idleResetStats();
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_RESAMPLER__
+/** @defgroup PRESSURE_RESAMPLE Resampling */                     /** @{ */
+
+/**
+ * @brief Resampler init function
+ *
+ * @param[out] rs                       Pointer to the resampler state
+ * @param[in]  mode                     _PRESSURE_RESAMPLE_LINEAR or _PRESSURE_RESAMPLE_CUBIC
+ * @param[in]  gridStart                Tick of the first grid point
+ * @param[in]  gridPeriod               Grid period in ticks
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : unknown mode or zero period;
+ */
+uint8_t pressure_resamplerInit( T_pressure_resampler *rs, uint8_t mode, uint32_t gridStart, uint32_t gridPeriod );
+
+/**
+ * @brief Resampler push function
+ *
+ * @param[in,out] rs                    Pointer to the resampler state
+ * @param[in]     sample                Timestamped raw sample, e.g. from pressure_readSample()
+ * @param[out]    output                Raw pressure counts on the grid
+ * @param[in]     maxOutput             Output buffer size
+ *
+ * @return
+ * Number of output values
+ *
+ * Function add the sample and interpolate every grid point lying between the samples in fixed point.
+ * Outputs belong to consecutive grid ticks, starting at gridStart.
+ * Linear mode interpolates between the two newest samples. Cubic mode uses the Catmull-Rom spline
+ * over the four newest samples and lags one sample behind.
+ * Samples with timestamp not after the previous one are ignored, history is bounded to four samples.
+ *
+ * @note
+ * Grid points before the first interpolation interval, or those not fitting into
+ * the output buffer, are skipped and counted in rs->skipped.
+ */
+uint8_t pressure_resamplerPush( T_pressure_resampler *rs, T_pressure_sample *sample, uint32_t *output, uint8_t maxOutput );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_RATE__
+/** @defgroup PRESSURE_RATE Pressure Rate Estimator */            /** @{ */
+
+/**
+ * @brief Rate estimator init function
+ *
+ * @param[out] est                      Pointer to the estimator state
+ * @param[in]  sampleRate               Sample rate in 0.01 Hz ( 100 to 2500 for ODR 1 Hz to 25 Hz )
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : sample rate out of range;
+ *
+ * Function initialise least squares slope estimator over _PRESSURE_RATE_WINDOW samples.
+ * Define _PRESSURE_RATE_WINDOW ( 4 to 64 ) before including the header to change the window.
+ */
+uint8_t pressure_rateInit( T_pressure_rate *est, uint16_t sampleRate );
+
+/**
+ * @brief Rate estimator update function
+ *
+ * @param[in,out] est                   Pointer to the estimator state
+ * @param[in]     rawPressure           Raw 24-bit pressure counts
+ * @param[out]    result                Pressure rate and vertical speed
+ *
+ * @return
+ * - 0 : window not full yet, result not written;
+ * - 1 : result valid;
+ *
+ * Function add the sample to the sliding window and update the least squares slope
+ * with running sums in constant time, integer arithmetic only.
+ * Vertical speed uses the standard atmosphere scale height ( 8434.5 m ) at the window mean pressure.
+ *
+ * @note
+ * Step larger than 1 mbar between two samples restarts the window.
+ */
+uint8_t pressure_rateUpdate( T_pressure_rate *est, uint32_t rawPressure, T_pressure_rateResult *result );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_KALMAN__
+/** @defgroup PRESSURE_KALMAN Altitude Kalman Filter */           /** @{ */
+
+/**
+ * @brief Kalman filter init function
+ *
+ * @param[out] kf                       Pointer to the filter state
+ * @param[in]  resConfig                _PRESSURE_RES_CONFIG value in use
+ * @param[in]  outDataRate              Output data rate code as for pressure_setOutputDataRate()
+ * @param[in]  accelNoise               Vertical acceleration RMS of the platform in m/s^2
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : one shot ODR or non positive acceleration noise;
+ *
+ * Function initialise two state ( altitude, velocity ) filter. Sample period comes
+ * from the ODR, measurement noise from the AVGP pressure averaging ( 0.45 mbar RMS
+ * without averaging, divided by square root of the number of averages ).
+ * The first sample passed to pressure_kalmanUpdate() becomes altitude 0.
+ */
+uint8_t pressure_kalmanInit( T_pressure_kalman *kf, uint8_t resConfig, uint8_t outDataRate, float accelNoise );
+
+/**
+ * @brief Kalman filter update function
+ *
+ * @param[in,out] kf                    Pointer to the filter state
+ * @param[in]     rawPressure           Raw 24-bit pressure counts
+ *
+ * Function run one predict and correct step, results are in kf->altitude and kf->velocity.
+ *
+ * @note
+ * Pressure is converted to altitude by the isothermal atmosphere ( 8434.5 m scale height )
+ * expanded to third order around a reference, no logarithm or power function is called.
+ * The reference follows the pressure in steps of 1/64 ( about 130 m near sea level ),
+ * so the expansion error stays below 1 cm over the whole sensor range.
+ */
+void pressure_kalmanUpdate( T_pressure_kalman *kf, uint32_t rawPressure );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_MEDIAN__
+/** @defgroup PRESSURE_MEDIAN Median Filter */                    /** @{ */
+
+/**
+ * @brief Median filter init function
+ *
+ * @param[out] mf                       Pointer to the filter state
+ *
+ * Function clear the window of _PRESSURE_MEDIAN_WINDOW samples.
+ * Define _PRESSURE_MEDIAN_WINDOW ( odd, 5 to 63 ) before including the header to change the window.
+ */
+void pressure_medianInit( T_pressure_median *mf );
+
+/**
+ * @brief Median filter push function
+ *
+ * @param[in,out] mf                    Pointer to the filter state
+ * @param[in]     rawPressure           Raw 24-bit pressure counts
+ *
+ * @return
+ * Median of the last _PRESSURE_MEDIAN_WINDOW samples, of the samples so far until the window fills
+ *
+ * Function replace the oldest sample and restore both heaps in O( log n ), no sorting.
+ */
+uint32_t pressure_medianPush( T_pressure_median *mf, uint32_t rawPressure );
+
+                                                                       /** @} */
+#endif
+
+#ifdef   __PRESSURE_BATCH__
+/** @defgroup PRESSURE_BATCH Batched Delivery */                  /** @{ */
+
+/**
+ * @brief Batch setup function
+ *
+ * @param[in] source                    Data ready source
+ * - _PRESSURE_BATCH_POLL_STATUS : P_DA bit of _PRESSURE_STATUS_REG;
+ * - _PRESSURE_BATCH_POLL_INT    : INT pin, interrupt routed as data ready;
+ * @param[in] watermark                 Number of samples per consumer call, 1 to _PRESSURE_BATCH_SIZE
+ * @param[in] maxAge                    Maximal age of the oldest collected sample in ticks, 0 for no limit
+ * @param[in] batchFp                   Consumer function
+ *
+ * @return
+ * - _PRESSURE_OK        : success;
+ * - _PRESSURE_ERR_PARAM : invalid source or watermark;
+ *
+ * Function configure batched delivery and drop samples collected so far.
+ * Maximal age requires tick source set by pressure_setTickSource().
+ */
+uint8_t pressure_batchSetup( uint8_t source, uint8_t watermark, uint32_t maxAge, T_pressure_batchFp batchFp );
+
+/**
+ * @brief Batch service function
+ *
+ * @return
+ * Number of samples passed to the consumer, 0 when no batch was delivered
+ *
+ * Function read a new sample when data ready is signalled and call the consumer
+ * with the collected samples once the watermark or the maximal age is reached.
+ *
+ * @note
+ * Should be called from the main loop at least once per ODR period.
+ */
+uint8_t pressure_batchService();
+
+/**
+ * @brief Batch flush function
+ *
+ * @return
+ * Number of samples passed to the consumer
+ *
+ * Function deliver the collected samples regardless of watermark and age.
+ */
+uint8_t pressure_batchFlush();
+
+/**
+ * @brief Get batch statistics function
+ *
+ * @param[out] stats                    Pointer to the batch statistics structure
+ */
+void pressure_batchGetStats( T_pressure_batchStats *stats );
+
+/**
+ * @brief Reset batch statistics function
+ */
+void pressure_batchResetStats();
+
+                                                                       /** @} */
+#endif
 
                                                                        /** @} */
 #ifdef __cplusplus
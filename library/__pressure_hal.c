@@ -72,6 +72,15 @@
 // #define   __TX_PIN_OUTPUT__         9
 // #define   __SCL_PIN_OUTPUT__        10                                    
 // #define   __SDA_PIN_OUTPUT__        11    
+
+#ifdef __PRESSURE_DRV_UART__
+                 #define   __HAL_UART__
+#endif
+#ifdef __PRESSURE_BUS_RECOVERY__
+  #define   __SCL_PIN_OUTPUT__        10
+  #define   __SDA_PIN_INPUT__         11
+  #define   __SDA_PIN_OUTPUT__        11
+#endif
                                                                        /** @} */
 #ifdef __HAL_SPI__
 
@@ -120,7 +129,9 @@ static void hal_spiRead(uint8_t *pBuf, uint16_t nBytes);
  * @note
  * This function should not use CS pin.
  */
+#ifndef __PRESSURE_HAL_REPLAY__
 static void hal_spiTransfer(uint8_t *pIn, uint8_t *pOut, uint16_t nBytes);
+#endif
 
                                                                        /** @} */
 #endif
@@ -396,6 +407,52 @@ static void hal_gpioMap(T_HAL_P gpioObj)
 #endif
 }
                                                                        /** @} */
+#ifdef __PRESSURE_HAL_REPLAY__
+
+/** @defgroup PRESSURE_HAL_REPLAY HAL Trace Replay */             /** @{ */
+
+/**
+ * @brief hal_replayInit
+ *
+ * @param[in] trace            pointer to the captured trace
+ * @param[in] nBytes           trace size in bytes
+ *
+ * Function loads the trace which replaces I2C/SPI bus traffic.
+ */
+static void hal_replayInit(const uint8_t *trace, uint32_t nBytes);
+
+/**
+ * @brief hal_replayTick
+ *
+ * @return timestamp of the current trace record
+ */
+static uint32_t hal_replayTick();
+
+/**
+ * @brief hal_replayDone
+ *
+ * @return 1 if all trace records are consumed
+ */
+static uint8_t hal_replayDone();
+
+/**
+ * @brief hal_replayInt
+ *
+ * @return INT pin level of the trace at the current record
+ */
+static uint8_t hal_replayInt();
+
+/**
+ * @brief hal_replayMismatches
+ *
+ * @return number of driver transactions which differ from the trace records
+ */
+static uint32_t hal_replayMismatches();
+
+#include "__HAL_REPLAY.c"
+                                                                       /** @} */
+#else
+
 #ifdef __MIKROC_PRO_FOR_PIC__
 #include "__HAL_PIC.c"
 #endif
@@ -448,6 +505,8 @@ static void hal_gpioMap(T_HAL_P gpioObj)
 #endif
 #endif
 
+#endif
+
 /* -------------------------------------------------------------------------- */
 /*
   __pressure_hal.c